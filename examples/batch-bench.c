@@ -0,0 +1,140 @@
+#include <jspp.h>
+#include <jspp_batch.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NUM_STREAMS     50000   ///< Default number of streams
+#define BATCH_SIZE      1024
+#define NUM_BATCHES     20000
+#define FRAGMENT_SIZE   24
+#define MAX_TOKENS      16
+
+static const char message[] = "{\"type\":\"tick\",\"seq\":12345,\"symbol\":\"ABCD\",\"bid\":101.25,\"ask\":101.5}";
+
+/// Per-connection state of a fan-in service
+typedef struct _stream {
+    jspp_t      parser;
+    uint16_t    pos;        ///< Position of the next fragment in the message
+    uint64_t    num_tokens;
+    char        other[128]; ///< The rest of the connection state
+} stream_t;
+
+static stream_t * streams;
+static uint32_t   num_streams;
+static uint32_t * schedule; ///< Streams that receive fragments in each batch
+
+///< Starts the next message when the previous one has been parsed
+static void next_message(stream_t * stream, uint8_t status)
+{
+    if (stream->pos == sizeof(message) - 1 || status <= JSON_END) {
+        jspp_start(&stream->parser, "", 0);
+        stream->pos = 0;
+    }
+}
+
+static uint16_t next_fragment(stream_t * stream, const char ** text)
+{
+    uint16_t len = sizeof(message) - 1 - stream->pos;
+    if (len > FRAGMENT_SIZE) {
+        len = FRAGMENT_SIZE;
+    }
+    *text = message + stream->pos;
+    stream->pos += len;
+    return len;
+}
+
+static uint64_t run_sequential()
+{
+    uint64_t num_tokens = 0;
+    for (uint32_t b = 0; b < NUM_BATCHES; b++) {
+        const uint32_t * batch = schedule + (b % 64) * BATCH_SIZE;
+        for (uint32_t i = 0; i < BATCH_SIZE; i++) {
+            stream_t * stream = &streams[batch[i]];
+            const char * text;
+            uint16_t len = next_fragment(stream, &text);
+            uint8_t token = jspp_continue(&stream->parser, text, len);
+            while (token > JSON_CONTINUE) {
+                ++num_tokens;
+                token = jspp_next(&stream->parser);
+            }
+            next_message(stream, token);
+        }
+    }
+    return num_tokens;
+}
+
+static uint64_t run_batched()
+{
+    static jspp_batch_job_t jobs[BATCH_SIZE];
+    static jspp_batch_token_t tokens[BATCH_SIZE][MAX_TOKENS];
+    uint64_t num_tokens = 0;
+    for (uint32_t b = 0; b < NUM_BATCHES; b++) {
+        const uint32_t * batch = schedule + (b % 64) * BATCH_SIZE;
+        for (uint32_t i = 0; i < BATCH_SIZE; i++) {
+            stream_t * stream = &streams[batch[i]];
+            jobs[i].parser = &stream->parser;
+            jobs[i].text_len = next_fragment(stream, &jobs[i].text);
+            jobs[i].tokens = tokens[i];
+            jobs[i].capacity = MAX_TOKENS;
+            jobs[i].status = JSON_CONTINUE;
+        }
+        jspp_batch_run(jobs, BATCH_SIZE);
+        for (uint32_t i = 0; i < BATCH_SIZE; i++) {
+            num_tokens += jobs[i].count;
+            next_message(&streams[batch[i]], jobs[i].status);
+        }
+    }
+    return num_tokens;
+}
+
+static void reset()
+{
+    for (uint32_t i = 0; i < num_streams; i++) {
+        jspp_start(&streams[i].parser, "", 0);
+        streams[i].pos = 0;
+    }
+}
+
+static void run(const char * name, uint64_t (*parse)())
+{
+    reset();
+    clock_t start = clock();
+    uint64_t num_tokens = parse();
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    printf("%-12s %8.1f M fragments/s  %llu tokens\n", name, NUM_BATCHES * (double) BATCH_SIZE / seconds / 1e6,
+        (unsigned long long) num_tokens);
+}
+
+int main(int argc, char * argv[])
+{
+    // the benefit of prefetching shows when the state of all streams does not fit into the last level cache
+    num_streams = argc > 1 ? strtoul(argv[1], NULL, 10) : NUM_STREAMS;
+    if (num_streams < BATCH_SIZE) {
+        num_streams = BATCH_SIZE;
+    }
+    printf("%u streams, %.1f MB of stream state\n", num_streams, num_streams * (double) sizeof(stream_t) / 1e6);
+    streams = malloc(num_streams * sizeof(stream_t));
+    schedule = malloc(64 * BATCH_SIZE * sizeof(uint32_t));
+    if (!streams || !schedule) {
+        return 1;
+    }
+    memset(streams, 0, num_streams * sizeof(stream_t));
+    // each batch has fragments of random streams (a stream is not repeated within the batch)
+    srand(1);
+    for (uint32_t b = 0; b < 64; b++) {
+        uint32_t first = rand() % num_streams;
+        uint32_t step = num_streams % 7919 ? 7919 : 7927; // a prime that does not divide the number of streams, so the streams do not repeat
+        for (uint32_t i = 0; i < BATCH_SIZE; i++) {
+            schedule[b * BATCH_SIZE + i] = (uint32_t) ((first + (uint64_t) i * step) % num_streams);
+        }
+    }
+    run("sequential", run_sequential);
+    run("batched", run_batched);
+    run("sequential", run_sequential);
+    run("batched", run_batched);
+    free(schedule);
+    free(streams);
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <jspp.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#define DOCUMENT_SIZE   (8 * 1024 * 1024)
+#define FRAGMENT_SIZE   512
+
+/// Writes a JSON array of objects that resemble a typical web service response
+static size_t generate_records(char * doc, size_t size)
+{
+    size_t len = sprintf(doc, "[");
+    for (unsigned i = 0; len < size - 1024; i++) {
+        len += sprintf(doc + len,
+            "%s{\"id\":%u,\"name\":\"item %u\",\"price\":%u.%02u,\"tags\":[\"a\",\"b\"],"
+            "\"location\":{\"lat\":%d.%06u,\"lng\":%d.%06u},\"active\":%s,\"note\":null}",
+            i ? "," : "", i, i, i % 1000, i % 100, (int) (i % 180) - 90, i % 1000000, (int) (i % 360) - 180, (i * 7) % 1000000,
+            i % 2 ? "true" : "false");
+    }
+    len += sprintf(doc + len, "]");
+    return len;
+}
+
+struct counts {
+    unsigned long tokens;
+    unsigned long prices;   ///< `price` member names that are not split between fragments
+};
+
+/// The loop that an application would write in C
+static jspp::token_t count_c(const char * doc, size_t size, counts & result)
+{
+    jspp_t parser;
+    size_t pos = FRAGMENT_SIZE;
+    uint8_t token = jspp_start(&parser, doc, FRAGMENT_SIZE);
+    for (;;) {
+        if (token == JSON_CONTINUE) {
+            uint16_t len = size - pos < FRAGMENT_SIZE ? size - pos : FRAGMENT_SIZE;
+            token = jspp_continue(&parser, doc + pos, len);
+            pos += len;
+        } else if (token > JSON_CONTINUE) {
+            ++result.tokens;
+            if (token == JSON_MEMBER_NAME) {
+                uint16_t length;
+                const char * text = jspp_text(&parser, &length);
+                if (length == 5 && memcmp(text, "price", 5) == 0) {
+                    ++result.prices;
+                }
+            }
+            token = jspp_next(&parser);
+        } else {
+            return token;
+        }
+    }
+}
+
+/// The same loop over `jspp::parser`
+static jspp::token_t count_cpp(const char * doc, size_t size, counts & result)
+{
+    jspp::parser parser;
+    size_t pos = FRAGMENT_SIZE;
+    jspp::token_t token = parser.start(std::string_view(doc, FRAGMENT_SIZE));
+    for (;;) {
+        if (token == JSON_CONTINUE) {
+            size_t len = size - pos < FRAGMENT_SIZE ? size - pos : FRAGMENT_SIZE;
+            token = parser.resume(std::string_view(doc + pos, len));
+            pos += len;
+        } else if (jspp::is_element(token)) {
+            ++result.tokens;
+            if (token == JSON_MEMBER_NAME && jspp::is<"price">(parser.text())) {
+                ++result.prices;
+            }
+            token = parser.next();
+        } else {
+            return token;
+        }
+    }
+}
+
+/// The coroutine that counts the tokens as if the document were in memory
+static jspp::task count_tokens(jspp::stream & json, counts & result)
+{
+    for (;;) {
+        jspp::token_t token = co_await json.next();
+        if (!jspp::is_element(token)) {
+            co_return;
+        }
+        ++result.tokens;
+        if (token == JSON_MEMBER_NAME && jspp::match<"id", "name", "price">(json.text()) == 2) {
+            ++result.prices;
+        }
+    }
+}
+
+/// Pushes the fragments into the stream the coroutine reads
+static jspp::token_t count_coroutine(const char * doc, size_t size, counts & result)
+{
+    jspp::stream json;
+    jspp::task task = count_tokens(json, result);
+    for (size_t pos = 0; pos < size && !task.done(); pos += FRAGMENT_SIZE) {
+        json.push(std::string_view(doc + pos, size - pos < FRAGMENT_SIZE ? size - pos : FRAGMENT_SIZE));
+    }
+    return json.last();
+}
+
+typedef jspp::token_t (*counter_t)(const char * doc, size_t size, counts & result);
+
+static counts run(const char * name, const char * doc, size_t size, counter_t counter)
+{
+    double best = 0;
+    counts result;
+    for (int run = 0; run < 5; run++) {
+        result = counts();
+        clock_t start = clock();
+        jspp::token_t token = counter(doc, size, result);
+        double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+        if (token != JSON_END) {
+            printf("%-12s failed (token=%u)\n", name, token);
+            return counts();
+        }
+        if (run == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    printf("%-12s %8.1f MB/s  %lu tokens  %lu prices\n", name, size / best / 1e6, result.tokens, result.prices);
+    return result;
+}
+
+int main()
+{
+    char * doc = (char *) malloc(DOCUMENT_SIZE);
+    if (!doc) {
+        return 1;
+    }
+    size_t size = generate_records(doc, DOCUMENT_SIZE);
+    counts c = run("C loop", doc, size, count_c);
+    counts cpp = run("jspp::parser", doc, size, count_cpp);
+    counts coro = run("coroutine", doc, size, count_coroutine);
+    free(doc);
+    return !(c.tokens == cpp.tokens && c.prices == cpp.prices && c.tokens == coro.tokens && c.prices == coro.prices);
+}
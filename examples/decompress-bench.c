@@ -0,0 +1,264 @@
+#include <decompress.h>
+#include <jspp.h>
+#include <jspp_pipeline.h>
+#include <zlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define JSON_SIZE       (64 * 1024 * 1024)
+#define CHUNK_SIZE      16384   ///< Size of the compressed data fragments
+#define NUM_BUFFERS     4
+
+/// Parser state that is carried from one fragment to the next
+typedef struct _counter {
+    jspp_t      parser;
+    uint8_t     started;
+    uint8_t     token;
+    uint64_t    num_tokens;
+} counter_t;
+
+static void count_tokens(const char * data, uint16_t size, void * cb_data)
+{
+    counter_t * counter = cb_data;
+    uint8_t token;
+    if (!counter->started) {
+        counter->started = 1;
+        token = jspp_start(&counter->parser, data, size);
+    } else if (counter->token == JSON_CONTINUE) {
+        token = jspp_continue(&counter->parser, data, size);
+    } else {
+        return;
+    }
+    while (token > JSON_CONTINUE) {
+        if (token != JSON_MEMBER_NAME_PART && token != JSON_STRING_PART && token != JSON_NUMBER_PART) {
+            ++counter->num_tokens;
+        }
+        token = jspp_next(&counter->parser);
+    }
+    counter->token = token;
+}
+
+/// Writes a JSON array of objects that resemble a typical web service response
+static size_t generate(char * json, size_t size)
+{
+    size_t len = sprintf(json, "[\n");
+    for (unsigned i = 0; len < size - 1024; i++) {
+        len += sprintf(json + len,
+            "%s  { \"id\": %u, \"name\": \"item %u\", \"price\": %u.%02u, \"tags\": [ \"a\", \"b\" ],\n"
+            "    \"location\": { \"lat\": %d.%06u, \"lng\": %d.%06u }, \"active\": %s, \"note\": null }",
+            i ? ",\n" : "", i, i, i % 1000, i % 100, (int) (i % 180) - 90, i % 1000000, (int) (i % 360) - 180, (i * 7) % 1000000,
+            i % 2 ? "true" : "false");
+    }
+    len += sprintf(json + len, "\n]\n");
+    return len;
+}
+
+static size_t gzip(const char * json, size_t size, char * out, size_t out_size)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, 6, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return 0;
+    }
+    zs.next_in = (Bytef *) json;
+    zs.avail_in = size;
+    zs.next_out = (Bytef *) out;
+    zs.avail_out = out_size;
+    int rc = deflate(&zs, Z_FINISH);
+    deflateEnd(&zs);
+    return rc == Z_STREAM_END ? out_size - zs.avail_out : 0;
+}
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static const char * compressed;
+static size_t compressed_size;
+static size_t json_size;
+
+static void report(const char * name, double seconds, const counter_t * counter, size_t memory)
+{
+    if (counter && counter->token != JSON_END) {
+        printf("%-24s failed (token=%u)\n", name, counter->token);
+        return;
+    }
+    printf("%-24s %8.1f MB/s  %8zu KB buffers\n", name, json_size / seconds / 1e6, memory / 1024);
+}
+
+static void discard(const char * data, uint16_t size, void * cb_data)
+{
+    (void) data;
+    (void) size;
+    (void) cb_data;
+}
+
+///< Inflates the entire compressed JSON into one buffer
+static void inflate_all(char * json)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    inflateInit2(&zs, 15 + 32);
+    zs.next_in = (Bytef *) compressed;
+    zs.avail_in = compressed_size;
+    zs.next_out = (Bytef *) json;
+    zs.avail_out = json_size;
+    inflate(&zs, Z_FINISH);
+    inflateEnd(&zs);
+}
+
+///< Inflates the entire JSON and then parses it - that's what we are trying to avoid
+static void inflate_then_parse()
+{
+    double start = now();
+    char * json = malloc(json_size);
+    inflate_all(json);
+
+    counter_t counter;
+    memset(&counter, 0, sizeof(counter));
+    for (size_t pos = 0; pos < json_size; pos += CHUNK_SIZE) {
+        count_tokens(json + pos, json_size - pos < CHUNK_SIZE ? json_size - pos : CHUNK_SIZE, &counter);
+    }
+    free(json);
+    report("inflate, then parse", now() - start, &counter, json_size);
+}
+
+static void decompress(decompress_cb_t callback, void * callback_data, char * window, uint16_t window_size)
+{
+    decompress_t decompressor;
+    decompress_init(&decompressor, DECOMPRESS_AUTO, window, window_size, callback, callback_data);
+    for (size_t pos = 0; pos < compressed_size; pos += CHUNK_SIZE) {
+        decompress_fragment(compressed + pos, compressed_size - pos < CHUNK_SIZE ? compressed_size - pos : CHUNK_SIZE, &decompressor);
+    }
+    if (decompress_end(&decompressor) != 0) {
+        printf("decompression failed\n");
+    }
+}
+
+static void inflate_only()
+{
+    static char window[DECOMPRESS_WINDOW_SIZE];
+    double start = now();
+    decompress(discard, NULL, window, sizeof(window));
+    report("inflate only", now() - start, NULL, sizeof(window));
+}
+
+static void parse_only()
+{
+    char * json = malloc(json_size);
+    inflate_all(json);
+
+    counter_t counter;
+    memset(&counter, 0, sizeof(counter));
+    double start = now();
+    for (size_t pos = 0; pos < json_size; pos += DECOMPRESS_WINDOW_SIZE) {
+        count_tokens(json + pos, json_size - pos < DECOMPRESS_WINDOW_SIZE ? json_size - pos : DECOMPRESS_WINDOW_SIZE, &counter);
+    }
+    report("parse only", now() - start, &counter, 0);
+    free(json);
+}
+
+///< Inflates into a small window and parses each window as it fills up
+static void streaming()
+{
+    static char window[DECOMPRESS_WINDOW_SIZE];
+    counter_t counter;
+    memset(&counter, 0, sizeof(counter));
+    double start = now();
+    decompress(count_tokens, &counter, window, sizeof(window));
+    report("streaming", now() - start, &counter, sizeof(window));
+}
+
+static jspp_pipeline_t pipeline;
+static char buffers[NUM_BUFFERS][DECOMPRESS_WINDOW_SIZE];
+static atomic_int parser_done;
+
+///< Copies the decompressed data to the pipeline buffers
+static void publish(const char * data, uint16_t size, void * cb_data)
+{
+    (void) cb_data;
+    char * buffer;
+    while ((buffer = jspp_pipeline_acquire(&pipeline)) == NULL) {
+        if (atomic_load(&parser_done)) {
+            // the parser does not need the rest
+            return;
+        }
+        sched_yield();
+    }
+    memcpy(buffer, data, size);
+    jspp_pipeline_publish(&pipeline, buffer, size);
+}
+
+static void * decompressor_thread(void * arg)
+{
+    static char window[DECOMPRESS_WINDOW_SIZE];
+    (void) arg;
+    decompress(publish, NULL, window, sizeof(window));
+    char * buffer;
+    while ((buffer = jspp_pipeline_acquire(&pipeline)) == NULL) {
+        if (atomic_load(&parser_done)) {
+            return NULL;
+        }
+        sched_yield();
+    }
+    jspp_pipeline_publish(&pipeline, buffer, 0);
+    return NULL;
+}
+
+///< Inflates on one thread and parses on another
+static void pipelined()
+{
+    counter_t counter;
+    memset(&counter, 0, sizeof(counter));
+    jspp_pipeline_init(&pipeline, buffers[0], NUM_BUFFERS, DECOMPRESS_WINDOW_SIZE);
+
+    double start = now();
+    pthread_t thread;
+    pthread_create(&thread, NULL, decompressor_thread, NULL);
+    uint8_t token;
+    while ((token = jspp_pipeline_next(&pipeline)) > JSON_END) {
+        if (token == JSON_CONTINUE) {
+            sched_yield();
+        } else if (token != JSON_MEMBER_NAME_PART && token != JSON_STRING_PART && token != JSON_NUMBER_PART) {
+            ++counter.num_tokens;
+        }
+    }
+    counter.token = token;
+    atomic_store(&parser_done, 1);
+    pthread_join(thread, NULL);
+    report("pipelined", now() - start, &counter, sizeof(buffers) + DECOMPRESS_WINDOW_SIZE);
+}
+
+int main()
+{
+    char * json = malloc(JSON_SIZE);
+    char * gz = malloc(JSON_SIZE);
+    if (!json || !gz) {
+        return 1;
+    }
+    json_size = generate(json, JSON_SIZE);
+    compressed_size = gzip(json, json_size, gz, JSON_SIZE);
+    compressed = gz;
+    free(json);
+    if (compressed_size == 0) {
+        printf("compression failed\n");
+        return 1;
+    }
+    printf("%zu MB of JSON, %zu MB compressed\n", json_size >> 20, compressed_size >> 20);
+
+    inflate_only();
+    parse_only();
+    inflate_then_parse();
+    streaming();
+    pipelined();
+    free(gz);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#ifndef __DECOMPRESS_H
+#define __DECOMPRESS_H
+
+#include <stdint.h>
+
+#define DECOMPRESS_WINDOW_SIZE 16384 ///< Suggested size of the output window
+
+enum _decompress_formats {
+    DECOMPRESS_AUTO,    ///< gzip or zlib, or zstd (when it is supported) - detected by the header
+    DECOMPRESS_DEFLATE, ///< Raw deflate stream (HTTP `Content-Encoding: deflate` servers sometimes send it)
+    DECOMPRESS_ZSTD
+};
+
+typedef void (*decompress_cb_t)(const char * data, uint16_t size, void * cb_data);
+
+typedef struct _decompress {
+    void *          stream;         ///< zlib or zstd stream state
+    char *          window;         ///< Caller provided output buffer
+    uint16_t        window_size;
+    uint8_t         format;
+    uint8_t         status;         ///< 0 while the stream is being decompressed, see `decompress_end` otherwise
+    uint8_t         header_length;  ///< Number of bytes in `header`
+    uint8_t         header[4];      ///< The first bytes of the auto-detected stream that are collected until its format is known
+    decompress_cb_t callback;
+    void *          callback_data;
+} decompress_t;
+
+/**
+ * \brief Prepares the decompressor.
+ *
+ * \param decompressor  A pointer to the decompressor struct allocated by the caller
+ * \param format        One of the `_decompress_formats`
+ * \param window        The buffer for the decompressed data
+ * \param window_size   The size of the window
+ * \param callback      The function that will be called with the decompressed data
+ * \param callback_data The pointer that will be passed to the callback
+ *
+ * \return 0 on success or a positive number if the decompressor cannot be initialized
+ *
+ * Compressed data is inflated into the window and every time the window is full (and when the
+ * compressed data ends) the callback is called with its content. The window is reused as soon as
+ * the callback returns. That works with `jspp` as long as the callback keeps calling `jspp_next`
+ * until it returns `JSON_CONTINUE` - the parser does not reference the fragment after that. Thus
+ * the memory that is needed stays the same regardless of the uncompressed size.
+ */
+int decompress_init(decompress_t * decompressor, uint8_t format, char * window, uint16_t window_size,
+    decompress_cb_t callback, void * callback_data);
+
+/**
+ * \brief Decompresses the next fragment of the compressed data.
+ *
+ * \param data          The compressed data
+ * \param size          The size of the data
+ * \param decompressor  A pointer to the decompressor (as `void *`)
+ *
+ * The signature of this function matches the `read_ahead`, `read_sync` and `http_get` callbacks, so
+ * the decompressor can be placed between them and the JSON parser.
+ */
+void decompress_fragment(const char * data, uint16_t size, void * decompressor);
+
+/**
+ * \brief Releases the decompressor resources.
+ *
+ * \param decompressor A pointer to the decompressor struct
+ *
+ * \return 0 when the compressed stream has ended properly, 1 if it is truncated, 2 if the data are
+ *         not valid, 3 if the format is not supported.
+ */
+int decompress_end(decompress_t * decompressor);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef __HTTPFETCH_H
+#define __HTTPFETCH_H
+
+#include <httpget.h>
+
+/// One HTTP GET request of a batch
+typedef struct _http_fetch {
+    const char *    request;    ///< Request path
+    void *          cb_data;    ///< Response state that is passed to the callback
+    int             rc;         ///< 0 when the response has been received or a positive number that
+                                ///< indicates where the flow was interrupted
+} http_fetch_t;
+
+/// Called when the response has been received completely (or when the request failed)
+typedef void (*http_fetch_done_cb_t)(http_fetch_t * fetch);
+
+/**
+ * \brief Executes a batch of HTTP GET requests concurrently.
+ *
+ * \param host            Numeric IPv4 address or host name of the server
+ * \param port            Server port
+ * \param fetches         The requests
+ * \param num_fetches     Number of requests
+ * \param max_connections Maximum number of connections that are open at the same time
+ * \param read_size       Maximum size of data fragments passed to the callback
+ * \param callback        The function that will be called for each data fragment of each response
+ * \param done            The function that will be called when a request completes. Might be NULL.
+ *
+ * \return 0 if all the requests were executed (check `rc` of each request for its result) or a positive
+ *         number that indicates where the flow was interrupted.
+ *
+ * Each request gets its own non-blocking connection. The connections are multiplexed with epoll in
+ * the calling thread. Like `http_get` the callback receives response data fragment by fragment, but
+ * each call carries the `cb_data` of the response it belongs to, so each connection can have its
+ * own response parsing state machine.
+ */
+int http_fetch_all(const char * host, uint16_t port, http_fetch_t * fetches, unsigned num_fetches,
+    unsigned max_connections, uint16_t read_size, http_get_cb_t callback, http_fetch_done_cb_t done);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef __HTTPRESP_H
+#define __HTTPRESP_H
+
+#include <stdint.h>
+
+#define HTTP_RESP_LINE_SIZE 64 ///< Header lines are truncated to this size. Only short ones are of interest.
+
+typedef void (*http_resp_cb_t)(const char * data, uint16_t size, void * cb_data);
+
+/// Called when the response body has ended. `status` is the response status code.
+typedef void (*http_resp_done_cb_t)(uint16_t status, void * cb_data);
+
+typedef struct _http_resp {
+    uint64_t            remaining;      ///< Bytes left in the body (`Content-Length`) or in the current chunk
+    uint16_t            status;         ///< Status code of the current response
+    uint8_t             state;
+    uint8_t             framing;        ///< How the end of the body is found
+    uint8_t             line_length;
+    char                line[HTTP_RESP_LINE_SIZE]; ///< Current status or header line, or chunk-size line
+    http_resp_cb_t      callback;       ///< Receives the body
+    http_resp_done_cb_t done;           ///< Might be NULL
+    void *              callback_data;
+} http_resp_t;
+
+/**
+ * \brief Prepares the HTTP/1.1 response decoder.
+ *
+ * \param resp          A pointer to the decoder struct allocated by the caller
+ * \param callback      The function that will be called with the body bytes
+ * \param done          The function that will be called when the body ends. Might be NULL.
+ * \param callback_data The pointer that will be passed to the callbacks
+ *
+ * The decoder parses the status line and the headers, and then uses `Transfer-Encoding: chunked` or
+ * `Content-Length` to find where the body ends. Body bytes are not copied - the callback gets slices of
+ * the fragments that are passed to `http_resp_fragment`. A chunked body is passed one chunk (or a part
+ * of the chunk that is in the current fragment) at a time, so chunk boundaries look like ordinary
+ * fragment boundaries to `jspp_continue`.
+ *
+ * Once the body has ended the decoder expects the next response. Thus responses to requests that were
+ * sent over the same keep-alive connection can be fed to it back to back.
+ */
+void http_resp_init(http_resp_t * resp, http_resp_cb_t callback, http_resp_done_cb_t done, void * callback_data);
+
+/**
+ * \brief Decodes the next fragment of the response stream.
+ *
+ * \param data  The received data
+ * \param size  The size of the data
+ * \param resp  A pointer to the decoder (as `void *`)
+ *
+ * The signature of this function matches the `http_get` callback, so the decoder can be placed between
+ * it and the JSON parser.
+ */
+void http_resp_fragment(const char * data, uint16_t size, void * resp);
+
+/**
+ * \brief Finishes the response stream when the connection has been closed.
+ *
+ * \param resp A pointer to the decoder struct
+ *
+ * \return 0 if the stream has ended between responses (or the body that is delimited by the connection
+ *         close has ended), 1 if it is truncated, 2 if the response cannot be decoded.
+ */
+int http_resp_end(http_resp_t * resp);
+
+#endif
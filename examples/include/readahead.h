@@ -0,0 +1,100 @@
+#ifndef __READAHEAD_H
+#define __READAHEAD_H
+
+#include <stdint.h>
+
+#define READ_AHEAD_BUFFER_SIZE  16384   ///< Size of each fragment buffer
+#define READ_AHEAD_MAX_BUFFERS  8
+
+typedef void (*read_cb_t)(const char * data, uint16_t size, void * cb_data);
+
+/**
+ * \brief Reads the file, pipe or socket and calls the callback for each fragment in order.
+ *
+ * \param fd            Open file descriptor
+ * \param buffers       Caller provided memory for `num_buffers` fragment buffers of `READ_AHEAD_BUFFER_SIZE` bytes each
+ * \param num_buffers   Number of fragment buffers (2 to `READ_AHEAD_MAX_BUFFERS`). With fewer than 2 buffers
+ *                      the function falls back to `read_sync`.
+ * \param callback      The function that will be called for each fragment
+ * \param callback_data The pointer that will be passed to the callback
+ *
+ * \return 0 on success or a positive number that indicates where the flow was interrupted
+ *
+ * While the callback processes one buffer the next ones are being filled by io_uring. For regular
+ * files all the buffers are in flight at once. Pipes and sockets have one read in flight while the
+ * callback is running, as their reads must complete in order. The buffer is recycled as soon as
+ * the callback returns, so the callback must be done with it by then. This is the case with `jspp`
+ * as long as the callback keeps calling `jspp_next` until it returns `JSON_CONTINUE` - the parser
+ * does not reference the old fragment after that.
+ *
+ * When io_uring is not available the function falls back to `read_sync`.
+ */
+int read_ahead(int fd, char * buffers, uint8_t num_buffers, read_cb_t callback, void * callback_data);
+
+/**
+ * \brief Reads the file, pipe or socket with plain `read` calls.
+ *
+ * \param fd            Open file descriptor
+ * \param buffer_size   Size of the fragment buffer (up to `READ_AHEAD_BUFFER_SIZE`)
+ * \param callback      The function that will be called for each fragment
+ * \param callback_data The pointer that will be passed to the callback
+ *
+ * \return 0 on success or a positive number that indicates where the flow was interrupted
+ */
+int read_sync(int fd, uint16_t buffer_size, read_cb_t callback, void * callback_data);
+
+#define READ_ADAPTIVE_MIN_SIZE  256 ///< The smallest read size the adaptive reader shrinks to
+#define READ_ADAPTIVE_PERIOD    16  ///< Number of fragments between read size adjustments
+
+/// State and statistics of the adaptive reader
+typedef struct _read_adaptive {
+    char *      buffer;         ///< Caller provided fragment buffer
+    uint16_t    capacity;       ///< The size of the buffer - the memory cap
+    uint16_t    read_size;      ///< Current fragment size
+    uint64_t    fragments;      ///< Number of fragments passed to the callback
+    uint64_t    uncut;          ///< Fragments that had to be cut in the middle of a token
+    uint64_t    carried;        ///< Bytes carried forward to the next fragment
+    uint16_t    period_uncut;   ///< Statistics of the current period
+    uint16_t    period_short;   ///< Reads that returned less than a half of the requested size
+    uint32_t    period_carried;
+} read_adaptive_t;
+
+/**
+ * \brief Prepares the adaptive reader.
+ *
+ * \param reader    A pointer to the reader struct allocated by the caller
+ * \param buffer    The fragment buffer
+ * \param capacity  The size of the buffer. Fragments never exceed it.
+ * \param read_size The initial fragment size
+ */
+void read_adaptive_init(read_adaptive_t * reader, char * buffer, uint16_t capacity, uint16_t read_size);
+
+/**
+ * \brief Reads the file, pipe or socket and calls the callback for each fragment, adjusting the fragment size.
+ *
+ * \param fd            Open file descriptor
+ * \param reader        A pointer to the reader
+ * \param callback      The function that will be called for each fragment
+ * \param callback_data The pointer that will be passed to the callback
+ *
+ * \return 0 on success or a positive number that indicates where the flow was interrupted
+ *
+ * Fixed small reads make the parser return many tokens in parts - `JSON_*_PART` - which the
+ * application has to collect. This reader avoids that where it can:
+ * - The fragment is cut after the last new line, or after the last comma that follows the end of a
+ *   value, found near its end. The tail after the cut is carried forward to the beginning of the next
+ *   fragment. JSON strings cannot have raw new lines and values rarely end with a comma inside a
+ *   string, so the fragment most likely ends between tokens.
+ * - Short reads from pipes and sockets are collected until the fragment is at least half full.
+ * - Every `READ_ADAPTIVE_PERIOD` fragments the fragment size is doubled (up to the capacity) when
+ *   all reads have returned as much as they were asked for, when fragments often could not be cut
+ *   between tokens, or when the carried tails - which are about as long as the values - are long
+ *   compared to the fragment. It is halved (down to `READ_ADAPTIVE_MIN_SIZE`) when most reads
+ *   return less than a half of it anyway.
+ *
+ * A cut in the wrong place only makes the parser return a token in parts, so the JSON is parsed
+ * correctly regardless of the content.
+ */
+int read_adaptive(int fd, read_adaptive_t * reader, read_cb_t callback, void * callback_data);
+
+#endif
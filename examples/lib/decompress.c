@@ -0,0 +1,203 @@
+#include <decompress.h>
+#include <stdlib.h>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// decompressor status
+#define RUNNING     0
+#define TRUNCATED   1
+#define BAD_DATA    2
+#define UNSUPPORTED 3
+#define ENDED       4   ///< The compressed stream has ended. `decompress_end` reports it as 0.
+
+static const uint8_t zstd_magic[] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+static int init_zlib(decompress_t * decompressor)
+{
+    z_stream * zs = calloc(1, sizeof(z_stream));
+    if (!zs) {
+        return 1;
+    }
+    // 15 + 32 detects gzip and zlib headers, -15 expects raw deflate
+    if (inflateInit2(zs, decompressor->format == DECOMPRESS_DEFLATE ? -15 : 15 + 32) != Z_OK) {
+        free(zs);
+        return 2;
+    }
+    decompressor->stream = zs;
+    return 0;
+}
+
+static void inflate_zlib(decompress_t * decompressor, const char * data, uint16_t size)
+{
+    z_stream * zs = decompressor->stream;
+    zs->next_in = (Bytef *) data;
+    zs->avail_in = size;
+    while (decompressor->status == RUNNING && (zs->avail_in > 0 || zs->avail_out == 0)) {
+        zs->next_out = (Bytef *) decompressor->window;
+        zs->avail_out = decompressor->window_size;
+        int rc = inflate(zs, Z_NO_FLUSH);
+        if (rc == Z_STREAM_END) {
+            decompressor->status = ENDED;
+        } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+            decompressor->status = BAD_DATA;
+            return;
+        }
+        uint16_t length = decompressor->window_size - zs->avail_out;
+        if (length > 0) {
+            decompressor->callback(decompressor->window, length, decompressor->callback_data);
+        }
+        if (rc == Z_BUF_ERROR) {
+            // no progress was possible - more input is needed
+            break;
+        }
+    }
+}
+
+#ifdef HAVE_ZSTD
+
+static int init_zstd(decompress_t * decompressor)
+{
+    ZSTD_DStream * ds = ZSTD_createDStream();
+    if (!ds) {
+        return 1;
+    }
+    if (ZSTD_isError(ZSTD_initDStream(ds))) {
+        ZSTD_freeDStream(ds);
+        return 2;
+    }
+    decompressor->stream = ds;
+    return 0;
+}
+
+static void decompress_zstd(decompress_t * decompressor, const char * data, uint16_t size)
+{
+    ZSTD_inBuffer in = { data, size, 0 };
+    int window_full;
+    do {
+        ZSTD_outBuffer out = { decompressor->window, decompressor->window_size, 0 };
+        size_t rc = ZSTD_decompressStream(decompressor->stream, &out, &in);
+        if (ZSTD_isError(rc)) {
+            decompressor->status = BAD_DATA;
+            return;
+        }
+        if (rc == 0) {
+            // the frame is complete
+            decompressor->status = ENDED;
+        }
+        if (out.pos > 0) {
+            decompressor->callback(decompressor->window, out.pos, decompressor->callback_data);
+        }
+        // when the window is full zstd might still have buffered data to flush
+        window_full = out.pos == out.size;
+    } while (decompressor->status == RUNNING && (in.pos < in.size || window_full));
+}
+
+#endif
+
+int decompress_init(decompress_t * decompressor, uint8_t format, char * window, uint16_t window_size,
+    decompress_cb_t callback, void * callback_data)
+{
+    decompressor->stream = NULL;
+    decompressor->window = window;
+    decompressor->window_size = window_size;
+    decompressor->format = format;
+    decompressor->status = RUNNING;
+    decompressor->header_length = 0;
+    decompressor->callback = callback;
+    decompressor->callback_data = callback_data;
+    switch (format) {
+        case DECOMPRESS_AUTO: {
+            // the stream is created when the header arrives
+            return 0;
+        }
+        case DECOMPRESS_DEFLATE: {
+            return init_zlib(decompressor);
+        }
+#ifdef HAVE_ZSTD
+        case DECOMPRESS_ZSTD: {
+            return init_zstd(decompressor);
+        }
+#endif
+    }
+    decompressor->status = UNSUPPORTED;
+    return UNSUPPORTED;
+}
+
+static void decompress_data(decompress_t * decompressor, const char * data, uint16_t size)
+{
+#ifdef HAVE_ZSTD
+    if (decompressor->format == DECOMPRESS_ZSTD) {
+        decompress_zstd(decompressor, data, size);
+        return;
+    }
+#endif
+    inflate_zlib(decompressor, data, size);
+}
+
+///< Creates the stream for the format the collected header shows
+static int detect_format(decompress_t * decompressor)
+{
+    int is_zstd = 1;
+    for (unsigned i = 0; is_zstd && i < sizeof(zstd_magic); i++) {
+        is_zstd = decompressor->header[i] == zstd_magic[i];
+    }
+    if (!is_zstd) {
+        return init_zlib(decompressor) == 0 ? RUNNING : BAD_DATA;
+    }
+    decompressor->format = DECOMPRESS_ZSTD;
+#ifdef HAVE_ZSTD
+    return init_zstd(decompressor) == 0 ? RUNNING : BAD_DATA;
+#else
+    return UNSUPPORTED;
+#endif
+}
+
+void decompress_fragment(const char * data, uint16_t size, void * cb_data)
+{
+    decompress_t * decompressor = cb_data;
+    if (decompressor->status != RUNNING || size == 0) {
+        return;
+    }
+    if (!decompressor->stream) {
+        // The stream is auto-detected. Its first bytes might arrive in several fragments.
+        while (size > 0 && decompressor->header_length < sizeof(decompressor->header)) {
+            decompressor->header[decompressor->header_length++] = (uint8_t) *data++;
+            --size;
+        }
+        if (decompressor->header_length < sizeof(decompressor->header)) {
+            return;
+        }
+        decompressor->status = detect_format(decompressor);
+        if (decompressor->status != RUNNING) {
+            return;
+        }
+        decompress_data(decompressor, (const char *) decompressor->header, decompressor->header_length);
+        if (decompressor->status != RUNNING || size == 0) {
+            return;
+        }
+    }
+    decompress_data(decompressor, data, size);
+}
+
+int decompress_end(decompress_t * decompressor)
+{
+    if (decompressor->stream) {
+#ifdef HAVE_ZSTD
+        if (decompressor->format == DECOMPRESS_ZSTD) {
+            ZSTD_freeDStream(decompressor->stream);
+        } else
+#endif
+        {
+            inflateEnd(decompressor->stream);
+            free(decompressor->stream);
+        }
+        decompressor->stream = NULL;
+    }
+    switch (decompressor->status) {
+        case ENDED:   return 0;
+        case RUNNING: return TRUNCATED;
+    }
+    return decompressor->status;
+}
@@ -0,0 +1,211 @@
+#include <httpfetch.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+
+#define MAX_EVENTS  64
+
+enum _conn_states {
+    CONN_IDLE,
+    CONN_CONNECTING,
+    CONN_SENDING,
+    CONN_RECEIVING
+};
+
+typedef struct _conn {
+    int             sock;
+    uint8_t         state;
+    http_fetch_t *  fetch;
+    int             sent;
+    int             send_size;
+    char            request[256];
+} conn_t;
+
+typedef struct _fetcher {
+    int                     epoll;
+    struct sockaddr_in      addr;
+    const char *            host;
+    http_get_cb_t           handle_data;
+    http_fetch_done_cb_t    done;
+    http_fetch_t *          fetches;
+    unsigned                num_fetches;
+    unsigned                next_fetch;     ///< The request that will be started next
+    unsigned                num_active;     ///< Number of open connections
+} fetcher_t;
+
+static void finish(fetcher_t * fetcher, conn_t * conn, int rc)
+{
+    epoll_ctl(fetcher->epoll, EPOLL_CTL_DEL, conn->sock, NULL);
+    close(conn->sock);
+    conn->state = CONN_IDLE;
+    --fetcher->num_active;
+    conn->fetch->rc = rc;
+    if (fetcher->done) {
+        fetcher->done(conn->fetch);
+    }
+}
+
+///< Starts the next request on the idle connection
+static void start(fetcher_t * fetcher, conn_t * conn)
+{
+    while (fetcher->next_fetch < fetcher->num_fetches) {
+        http_fetch_t * fetch = &fetcher->fetches[fetcher->next_fetch++];
+        conn->fetch = fetch;
+        conn->sent = 0;
+        conn->send_size = snprintf(conn->request, sizeof(conn->request),
+            "GET %s HTTP/1.0\r\nHost: %s\r\nConnection: close\r\n\r\n", fetch->request, fetcher->host);
+        if (conn->send_size < 0 || sizeof(conn->request) <= (size_t) conn->send_size) {
+            fetch->rc = 1;
+            if (fetcher->done) fetcher->done(fetch);
+            continue;
+        }
+        conn->sock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (conn->sock < 0) {
+            fetch->rc = 4;
+            if (fetcher->done) fetcher->done(fetch);
+            continue;
+        }
+        ++fetcher->num_active;
+        conn->state = CONN_CONNECTING;
+        if (connect(conn->sock, (struct sockaddr *) &fetcher->addr, sizeof(fetcher->addr)) < 0 && errno != EINPROGRESS) {
+            finish(fetcher, conn, 5);
+            continue;
+        }
+        struct epoll_event event = { .events = EPOLLOUT, .data.ptr = conn };
+        if (epoll_ctl(fetcher->epoll, EPOLL_CTL_ADD, conn->sock, &event) < 0) {
+            close(conn->sock);
+            conn->state = CONN_IDLE;
+            --fetcher->num_active;
+            fetch->rc = 8;
+            if (fetcher->done) fetcher->done(fetch);
+            continue;
+        }
+        return;
+    }
+}
+
+static void send_request(fetcher_t * fetcher, conn_t * conn)
+{
+    if (conn->state == CONN_CONNECTING) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(conn->sock, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err != 0) {
+            finish(fetcher, conn, 5);
+            return;
+        }
+        conn->state = CONN_SENDING;
+    }
+    while (conn->sent < conn->send_size) {
+        int sent_now = write(conn->sock, conn->request + conn->sent, conn->send_size - conn->sent);
+        if (sent_now < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            }
+            finish(fetcher, conn, 6);
+            return;
+        }
+        conn->sent += sent_now;
+    }
+    conn->state = CONN_RECEIVING;
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = conn };
+    epoll_ctl(fetcher->epoll, EPOLL_CTL_MOD, conn->sock, &event);
+}
+
+static void receive_response(fetcher_t * fetcher, conn_t * conn, char * buf, uint16_t read_size)
+{
+    int recv_size = read(conn->sock, buf, read_size);
+    if (recv_size > 0) {
+        fetcher->handle_data(buf, recv_size, conn->fetch->cb_data);
+    } else if (recv_size == 0) {
+        finish(fetcher, conn, 0);
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        finish(fetcher, conn, 7);
+    }
+}
+
+int http_fetch_all(const char * host, uint16_t port, http_fetch_t * fetches, unsigned num_fetches,
+    unsigned max_connections, uint16_t read_size, http_get_cb_t handle_data, http_fetch_done_cb_t done)
+{
+    fetcher_t fetcher;
+    memset(&fetcher, 0, sizeof(fetcher));
+    fetcher.addr.sin_family = AF_INET;
+    fetcher.addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &fetcher.addr.sin_addr) != 1) {
+        struct hostent * hostinfo = gethostbyname(host);
+        if (hostinfo == NULL || hostinfo->h_addrtype != AF_INET) {
+            return 3;
+        }
+        fetcher.addr.sin_addr = *(struct in_addr *) hostinfo->h_addr;
+    }
+    fetcher.host = host;
+    fetcher.handle_data = handle_data;
+    fetcher.done = done;
+    fetcher.fetches = fetches;
+    fetcher.num_fetches = num_fetches;
+
+    if (max_connections == 0) {
+        max_connections = 1;
+    }
+    if (read_size == 0) {
+        read_size = 256;
+    }
+    conn_t * conns = calloc(max_connections, sizeof(conn_t));
+    char * buf = malloc(read_size);
+    if (!conns || !buf) {
+        free(conns);
+        free(buf);
+        return 9;
+    }
+    fetcher.epoll = epoll_create1(0);
+    if (fetcher.epoll < 0) {
+        free(conns);
+        free(buf);
+        return 8;
+    }
+
+    for (unsigned i = 0; i < max_connections; i++) {
+        start(&fetcher, &conns[i]);
+    }
+    int rc = 0;
+    while (fetcher.num_active > 0) {
+        struct epoll_event events[MAX_EVENTS];
+        int num_events = epoll_wait(fetcher.epoll, events, MAX_EVENTS, -1);
+        if (num_events < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            rc = 8;
+            break;
+        }
+        for (int i = 0; i < num_events; i++) {
+            conn_t * conn = events[i].data.ptr;
+            if (conn->state == CONN_RECEIVING) {
+                receive_response(&fetcher, conn, buf, read_size);
+            } else {
+                send_request(&fetcher, conn);
+            }
+            if (conn->state == CONN_IDLE) {
+                // reuse the connection slot for the next request
+                start(&fetcher, conn);
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < max_connections; i++) {
+        if (conns[i].state != CONN_IDLE) {
+            close(conns[i].sock);
+        }
+    }
+    close(fetcher.epoll);
+    free(conns);
+    free(buf);
+    return rc;
+}
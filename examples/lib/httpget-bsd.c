@@ -9,7 +9,7 @@
 int http_get(const char * host, const char * request, http_get_cb_t handle_data, void * callback_data)
 {
     char buf[256];
-    int send_size = snprintf(buf, sizeof(buf), "GET %s HTTP/1.0\r\nHost: %s\r\nConnection: close\r\n\r\n", request, host);
+    int send_size = snprintf(buf, sizeof(buf), "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n", request, host);
     if (send_size < 0 || sizeof(buf) <= send_size) {
         return 1;
     }
@@ -0,0 +1,255 @@
+#include <httpresp.h>
+#include <string.h>
+
+// decoder states
+enum _http_resp_states {
+    STATUS_LINE,
+    HEADER_LINE,
+    BODY,               ///< `Content-Length` bytes
+    BODY_UNTIL_CLOSE,   ///< Neither `Content-Length` nor chunked - the body ends when the connection is closed
+    CHUNK_SIZE_LINE,
+    CHUNK_DATA,
+    CHUNK_DATA_END,     ///< CRLF after the chunk data
+    TRAILER_LINE,
+    FAILED
+};
+
+// body framing
+enum _http_resp_framing {
+    UNTIL_CLOSE,
+    CONTENT_LENGTH,
+    CHUNKED
+};
+
+static uint8_t to_lower(char c)
+{
+    return 'A' <= c && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+/// Checks whether the line starts with the (lower case) header name
+static int is_header(const char * line, uint8_t length, const char * name, uint8_t name_length)
+{
+    if (length < name_length) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < name_length; i++) {
+        if (to_lower(line[i]) != name[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/// Checks whether the (lower case) word is in the text
+static int contains(const char * text, uint8_t length, const char * word, uint8_t word_length)
+{
+    for (uint8_t i = 0; i + word_length <= length; i++) {
+        if (is_header(text + i, length - i, word, word_length)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief Collects the next line.
+ *
+ * \return Pointer to the first byte after the line feed. Or NULL if the line does not end in this
+ *         fragment. In the latter case the line collected so far is kept in `resp->line`.
+ *
+ * The trailing CR is removed. Lines that are too long are truncated.
+ */
+static const char * read_line(const char * data, const char * end, http_resp_t * resp)
+{
+    const char * lf = memchr(data, '\n', end - data);
+    const char * line_end = lf ? lf : end;
+    uint16_t free_space = sizeof(resp->line) - resp->line_length;
+    uint16_t length = line_end - data < free_space ? line_end - data : free_space;
+    memcpy(resp->line + resp->line_length, data, length);
+    resp->line_length += length;
+    if (!lf) {
+        return NULL;
+    }
+    if (resp->line_length > 0 && resp->line[resp->line_length - 1] == '\r') {
+        --resp->line_length;
+    }
+    return lf + 1;
+}
+
+static void end_body(http_resp_t * resp)
+{
+    resp->state = STATUS_LINE;
+    if (resp->done) {
+        resp->done(resp->status, resp->callback_data);
+    }
+}
+
+static void parse_status_line(http_resp_t * resp)
+{
+    const char * line = resp->line;
+    if (resp->line_length == 0) {
+        // tolerate empty lines between responses
+        return;
+    }
+    if (resp->line_length < 12 || memcmp(line, "HTTP/1.", 7) != 0 || line[8] != ' ') {
+        resp->state = FAILED;
+        return;
+    }
+    resp->status = 0;
+    for (int i = 9; i < 12; i++) {
+        if (line[i] < '0' || '9' < line[i]) {
+            resp->state = FAILED;
+            return;
+        }
+        resp->status = resp->status * 10 + (line[i] - '0');
+    }
+    resp->framing = UNTIL_CLOSE;
+    resp->remaining = 0;
+    resp->state = HEADER_LINE;
+}
+
+static void parse_header_line(http_resp_t * resp)
+{
+    const char * line = resp->line;
+    uint8_t length = resp->line_length;
+    if (length == 0) {
+        // the end of headers
+        if (resp->status < 200) {
+            // interim response (like 100 Continue) - the actual one follows
+            resp->state = STATUS_LINE;
+        } else if (resp->status == 204 || resp->status == 304) {
+            end_body(resp);
+        } else if (resp->framing == CHUNKED) {
+            resp->state = CHUNK_SIZE_LINE;
+        } else if (resp->framing == UNTIL_CLOSE) {
+            resp->state = BODY_UNTIL_CLOSE;
+        } else if (resp->remaining > 0) {
+            resp->state = BODY;
+        } else {
+            end_body(resp);
+        }
+        return;
+    }
+    if (is_header(line, length, "transfer-encoding:", 18)) {
+        if (contains(line + 18, length - 18, "chunked", 7)) {
+            resp->framing = CHUNKED;
+        }
+    } else if (is_header(line, length, "content-length:", 15) && resp->framing != CHUNKED) {
+        uint8_t i = 15;
+        while (i < length && (line[i] == ' ' || line[i] == '\t')) ++i;
+        if (i == length) {
+            resp->state = FAILED;
+            return;
+        }
+        resp->remaining = 0;
+        while (i < length && '0' <= line[i] && line[i] <= '9') {
+            resp->remaining = resp->remaining * 10 + (line[i++] - '0');
+        }
+        resp->framing = CONTENT_LENGTH;
+    }
+}
+
+static void parse_chunk_size_line(http_resp_t * resp)
+{
+    uint8_t i = 0;
+    resp->remaining = 0;
+    for (; i < resp->line_length && i < 16; i++) {
+        uint8_t c = to_lower(resp->line[i]);
+        if ('0' <= c && c <= '9') {
+            resp->remaining = resp->remaining * 16 + (c - '0');
+        } else if ('a' <= c && c <= 'f') {
+            resp->remaining = resp->remaining * 16 + (c - 'a' + 10);
+        } else {
+            // chunk extensions (if any) follow the size and are ignored
+            break;
+        }
+    }
+    if (i == 0) {
+        resp->state = FAILED;
+    } else {
+        resp->state = resp->remaining > 0 ? CHUNK_DATA : TRAILER_LINE;
+    }
+}
+
+/// Passes the body bytes, up to the end of the body or chunk, to the callback
+static const char * pass_body(const char * data, const char * end, http_resp_t * resp)
+{
+    uint16_t size = end - data;
+    if (resp->state != BODY_UNTIL_CLOSE && resp->remaining < size) {
+        size = resp->remaining;
+    }
+    resp->callback(data, size, resp->callback_data);
+    resp->remaining -= size;
+    return data + size;
+}
+
+void http_resp_init(http_resp_t * resp, http_resp_cb_t callback, http_resp_done_cb_t done, void * callback_data)
+{
+    resp->remaining = 0;
+    resp->status = 0;
+    resp->state = STATUS_LINE;
+    resp->framing = UNTIL_CLOSE;
+    resp->line_length = 0;
+    resp->callback = callback;
+    resp->done = done;
+    resp->callback_data = callback_data;
+}
+
+void http_resp_fragment(const char * data, uint16_t size, void * cb_data)
+{
+    http_resp_t * resp = cb_data;
+    const char * end = data + size;
+    while (data < end && resp->state != FAILED) {
+        switch (resp->state) {
+            case BODY_UNTIL_CLOSE: {
+                data = pass_body(data, end, resp);
+                break;
+            }
+            case BODY: {
+                data = pass_body(data, end, resp);
+                if (resp->remaining == 0) {
+                    end_body(resp);
+                }
+                break;
+            }
+            case CHUNK_DATA: {
+                data = pass_body(data, end, resp);
+                if (resp->remaining == 0) {
+                    resp->state = CHUNK_DATA_END;
+                }
+                break;
+            }
+            default: {
+                data = read_line(data, end, resp);
+                if (!data) {
+                    return;
+                }
+                switch (resp->state) {
+                    case STATUS_LINE:       parse_status_line(resp); break;
+                    case HEADER_LINE:       parse_header_line(resp); break;
+                    case CHUNK_SIZE_LINE:   parse_chunk_size_line(resp); break;
+                    case CHUNK_DATA_END:    resp->state = resp->line_length == 0 ? CHUNK_SIZE_LINE : FAILED; break;
+                    case TRAILER_LINE:      if (resp->line_length == 0) end_body(resp); break;
+                }
+                resp->line_length = 0;
+            }
+        }
+    }
+}
+
+int http_resp_end(http_resp_t * resp)
+{
+    switch (resp->state) {
+        case STATUS_LINE: {
+            return resp->line_length == 0 ? 0 : 1;
+        }
+        case BODY_UNTIL_CLOSE: {
+            end_body(resp);
+            return 0;
+        }
+        case FAILED: {
+            return 2;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,367 @@
+#include <readahead.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+int read_sync(int fd, uint16_t buffer_size, read_cb_t handle_data, void * callback_data)
+{
+    char buf[READ_AHEAD_BUFFER_SIZE];
+    if (buffer_size == 0 || buffer_size > sizeof(buf)) {
+        buffer_size = sizeof(buf);
+    }
+    int recv_size;
+    while ((recv_size = read(fd, buf, buffer_size)) > 0) {
+        handle_data(buf, recv_size, callback_data);
+    }
+    return recv_size < 0 ? 1 : 0;
+}
+
+void read_adaptive_init(read_adaptive_t * reader, char * buffer, uint16_t capacity, uint16_t read_size)
+{
+    reader->buffer = buffer;
+    reader->capacity = capacity;
+    reader->read_size = read_size < READ_ADAPTIVE_MIN_SIZE ? READ_ADAPTIVE_MIN_SIZE : read_size;
+    if (reader->read_size > capacity) {
+        reader->read_size = capacity;
+    }
+    reader->fragments = 0;
+    reader->uncut = 0;
+    reader->carried = 0;
+    reader->period_uncut = 0;
+    reader->period_short = 0;
+    reader->period_carried = 0;
+}
+
+/**
+ * \brief Finds where the fragment can be cut between tokens.
+ *
+ * \return The size of the fragment up to the cut or 0 if there is no suitable place in the last `window` bytes
+ */
+static uint16_t find_cut(const char * data, uint16_t size, uint16_t window)
+{
+    uint16_t stop = size > window ? size - window : 0;
+    for (uint16_t i = size; i > stop; i--) {
+        char c = data[i - 1];
+        if (c == '\n') {
+            return i;
+        }
+        if (c == ',' && i >= 2) {
+            // the comma after a string, a number, a literal, an object or an array
+            char p = data[i - 2];
+            if (p == '}' || p == ']' || p == 'e' || p == 'l' || ('0' <= p && p <= '9')
+                || (p == '"' && (i < 3 || data[i - 3] != '\\'))) {
+                return i;
+            }
+        }
+    }
+    return 0;
+}
+
+static void adapt(read_adaptive_t * reader)
+{
+    uint32_t average_tail = reader->period_carried / READ_ADAPTIVE_PERIOD;
+    // the source has more data ready than it is asked for, or the tokens are long compared to the fragments
+    int grow = reader->period_short == 0 || reader->period_uncut * 8 > READ_ADAPTIVE_PERIOD
+        || average_tail > reader->read_size / 16;
+    if (grow && reader->read_size <= reader->capacity / 2) {
+        reader->read_size *= 2;
+    } else if (reader->period_short * 2 > READ_ADAPTIVE_PERIOD && reader->period_uncut == 0
+        && reader->read_size / 2 >= READ_ADAPTIVE_MIN_SIZE) {
+        reader->read_size /= 2;
+    }
+    reader->period_uncut = 0;
+    reader->period_short = 0;
+    reader->period_carried = 0;
+}
+
+int read_adaptive(int fd, read_adaptive_t * reader, read_cb_t handle_data, void * callback_data)
+{
+    char * buf = reader->buffer;
+    uint16_t length = 0; // carried tail and the data read so far
+    for (;;) {
+        uint16_t size = reader->read_size > length ? reader->read_size - length : reader->capacity - length;
+        int recv_size = read(fd, buf + length, size);
+        if (recv_size <= 0) {
+            if (length > 0) {
+                handle_data(buf, length, callback_data);
+                ++reader->fragments;
+            }
+            return recv_size < 0 ? 1 : 0;
+        }
+        if (recv_size < size / 2) {
+            ++reader->period_short;
+        }
+        length += recv_size;
+        if (length < reader->read_size / 2) {
+            // collect more of the short reads
+            continue;
+        }
+
+        uint16_t cut = find_cut(buf, length, reader->read_size / 4);
+        if (cut == 0) {
+            cut = length;
+            ++reader->uncut;
+            ++reader->period_uncut;
+        }
+        handle_data(buf, cut, callback_data);
+        length -= cut;
+        memmove(buf, buf + cut, length);
+        reader->carried += length;
+        reader->period_carried += length;
+        if (++reader->fragments % READ_ADAPTIVE_PERIOD == 0) {
+            adapt(reader);
+        }
+    }
+}
+
+#ifdef __linux__
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+// liburing is not required. The ring is set up with the raw system calls.
+
+typedef struct _ring {
+    int                     fd;
+    unsigned *              sq_tail;
+    unsigned *              sq_mask;
+    unsigned *              sq_array;
+    struct io_uring_sqe *   sqes;
+    unsigned *              cq_head;
+    unsigned *              cq_tail;
+    unsigned *              cq_mask;
+    struct io_uring_cqe *   cqes;
+    void *                  sq_ptr;
+    size_t                  sq_size;
+    void *                  cq_ptr;
+    size_t                  cq_size;
+    size_t                  sqes_size;
+} ring_t;
+
+static int ring_setup(ring_t * ring, unsigned entries)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring->fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0) {
+        return -1;
+    }
+
+    ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_size > ring->sq_size) {
+            ring->sq_size = ring->cq_size;
+        }
+        ring->cq_size = ring->sq_size;
+    }
+    ring->sq_ptr = mmap(0, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ptr == MAP_FAILED) {
+        close(ring->fd);
+        return -1;
+    }
+    ring->cq_ptr = ring->sq_ptr;
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+        ring->cq_ptr = mmap(0, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ptr == MAP_FAILED) {
+            munmap(ring->sq_ptr, ring->sq_size);
+            close(ring->fd);
+            return -1;
+        }
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(0, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        if (ring->cq_ptr != ring->sq_ptr) {
+            munmap(ring->cq_ptr, ring->cq_size);
+        }
+        munmap(ring->sq_ptr, ring->sq_size);
+        close(ring->fd);
+        return -1;
+    }
+
+    char * sq = ring->sq_ptr;
+    ring->sq_tail  = (unsigned *) (sq + params.sq_off.tail);
+    ring->sq_mask  = (unsigned *) (sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *) (sq + params.sq_off.array);
+    char * cq = ring->cq_ptr;
+    ring->cq_head  = (unsigned *) (cq + params.cq_off.head);
+    ring->cq_tail  = (unsigned *) (cq + params.cq_off.tail);
+    ring->cq_mask  = (unsigned *) (cq + params.cq_off.ring_mask);
+    ring->cqes     = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+    return 0;
+}
+
+static void ring_close(ring_t * ring)
+{
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ptr != ring->sq_ptr) {
+        munmap(ring->cq_ptr, ring->cq_size);
+    }
+    munmap(ring->sq_ptr, ring->sq_size);
+    close(ring->fd);
+}
+
+///< Queues and submits a read request
+static int ring_read(ring_t * ring, int fd, char * buf, unsigned length, uint64_t offset, uint64_t user_data)
+{
+    unsigned tail = *ring->sq_tail;
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe * sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t) (uintptr_t) buf;
+    sqe->len = length;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    return syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0) == 1 ? 0 : -1;
+}
+
+///< Waits for a completion
+static int ring_wait(ring_t * ring, uint64_t * user_data, int * result)
+{
+    unsigned head = *ring->cq_head;
+    while (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+        if (syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0) {
+            return -1;
+        }
+    }
+    struct io_uring_cqe * cqe = &ring->cqes[head & *ring->cq_mask];
+    *user_data = cqe->user_data;
+    *result = cqe->res;
+    __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+typedef struct _slot {
+    uint64_t    offset;     ///< File offset of the read
+    unsigned    length;     ///< Number of bytes requested
+    int         result;     ///< Number of bytes read or negative error code
+    uint8_t     done;       ///< The read has completed
+} slot_t;
+
+///< Returns the fragment buffer with the specified index
+static inline char * buffer_at(char * buffers, uint8_t index)
+{
+    return buffers + (uint32_t) index * READ_AHEAD_BUFFER_SIZE;
+}
+
+int read_ahead(int fd, char * buffers, uint8_t num_buffers, read_cb_t handle_data, void * callback_data)
+{
+    slot_t slots[READ_AHEAD_MAX_BUFFERS];
+    ring_t ring;
+
+    if (num_buffers < 2) {
+        return read_sync(fd, READ_AHEAD_BUFFER_SIZE, handle_data, callback_data);
+    }
+    if (num_buffers > READ_AHEAD_MAX_BUFFERS) {
+        num_buffers = READ_AHEAD_MAX_BUFFERS;
+    }
+    if (ring_setup(&ring, READ_AHEAD_MAX_BUFFERS) < 0) {
+        return read_sync(fd, READ_AHEAD_BUFFER_SIZE, handle_data, callback_data);
+    }
+
+    // Regular files are read at explicit offsets, so several reads can be in flight. Pipes and
+    // sockets are read at their "current position" (-1), one read at a time.
+    struct stat st;
+    int seekable = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    uint64_t offset = seekable ? (uint64_t) lseek(fd, 0, SEEK_CUR) : (uint64_t) -1;
+    int in_flight = 0;
+    int rc = 0;
+
+    for (uint8_t i = 0; i < (seekable ? num_buffers : 1); i++) {
+        slots[i].offset = offset;
+        slots[i].length = READ_AHEAD_BUFFER_SIZE;
+        slots[i].done = 0;
+        if (ring_read(&ring, fd, buffer_at(buffers, i), READ_AHEAD_BUFFER_SIZE, offset, i) < 0) {
+            rc = 2;
+            break;
+        }
+        ++in_flight;
+        if (seekable) {
+            offset += READ_AHEAD_BUFFER_SIZE;
+        }
+    }
+
+    uint8_t next = 0; // the buffer that is delivered next
+    while (in_flight > 0 && rc == 0) {
+        while (!slots[next].done) {
+            uint64_t index;
+            int result;
+            if (ring_wait(&ring, &index, &result) < 0) {
+                rc = 4;
+                break;
+            }
+            slots[index].result = result;
+            slots[index].done = 1;
+            --in_flight;
+        }
+        slot_t * slot = &slots[next];
+        if (rc || slot->result <= 0) {
+            if (slot->result < 0) {
+                rc = 3;
+            }
+            break;
+        }
+        slot->done = 0;
+
+        uint8_t following = (next + 1) % num_buffers;
+        if (!seekable) {
+            // start filling the next buffer before this one is processed
+            slots[following].done = 0;
+            if (ring_read(&ring, fd, buffer_at(buffers, following), READ_AHEAD_BUFFER_SIZE, offset, following) < 0) {
+                rc = 2;
+            } else {
+                ++in_flight;
+            }
+        }
+
+        handle_data(buffer_at(buffers, next), slot->result, callback_data);
+
+        if (seekable && rc == 0) {
+            // the buffer is free - reuse it for the next read
+            if ((unsigned) slot->result < slot->length) {
+                // short read - read the rest of the same range before moving on
+                slot->offset += slot->result;
+                slot->length -= slot->result;
+                following = next;
+            } else {
+                slot->offset = offset;
+                slot->length = READ_AHEAD_BUFFER_SIZE;
+                offset += READ_AHEAD_BUFFER_SIZE;
+            }
+            if (ring_read(&ring, fd, buffer_at(buffers, next), slot->length, slot->offset, next) < 0) {
+                rc = 2;
+            } else {
+                ++in_flight;
+            }
+        }
+        next = following;
+    }
+    // the kernel might still be writing into the buffers past the end of file
+    while (in_flight > 0 && rc != 4) {
+        uint64_t index;
+        int result;
+        if (ring_wait(&ring, &index, &result) < 0) {
+            break;
+        }
+        --in_flight;
+    }
+    ring_close(&ring);
+    return rc;
+}
+
+#else
+
+int read_ahead(int fd, char * buffers, uint8_t num_buffers, read_cb_t handle_data, void * callback_data)
+{
+    (void) buffers;
+    (void) num_buffers;
+    return read_sync(fd, READ_AHEAD_BUFFER_SIZE, handle_data, callback_data);
+}
+
+#endif
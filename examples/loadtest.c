@@ -0,0 +1,240 @@
+#include <httpfetch.h>
+#include <jspp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+// The loopback server responds to every request with this
+static const char response[] =
+    "HTTP/1.0 200 OK\r\n"
+    "Content-Type: application/json\r\n"
+    "Connection: close\r\n"
+    "\r\n"
+    "{\"results\":{\"sunrise\":\"7:27:02 AM\",\"sunset\":\"5:05:55 PM\",\"solar_noon\":\"12:16:28 PM\","
+    "\"day_length\":\"9:38:53\",\"civil_twilight_begin\":\"6:58:14 AM\",\"civil_twilight_end\":\"5:34:43 PM\","
+    "\"nautical_twilight_begin\":\"6:25:47 AM\",\"nautical_twilight_end\":\"6:07:10 PM\","
+    "\"astronomical_twilight_begin\":\"5:54:14 AM\",\"astronomical_twilight_end\":\"6:38:43 PM\"},"
+    "\"status\":\"OK\"}";
+
+enum _resp_states {
+    SKIPPING_RESPONSE_HEADER = 0,
+    RESPONSE_HEADER_TERM_CR_FOUND,
+    RESPONSE_HEADER_TERM_LF_FOUND,
+    HEADERS_TERM_CR_FOUND,
+    HEADERS_SKIPPED,
+    PARSING,
+    DONE,
+    PARSING_FAILED
+};
+
+/// Per connection response processing state
+typedef struct _resp {
+    jspp_t          json_parser;
+    uint8_t         state;
+    uint32_t        num_tokens;
+    struct timespec first_byte;
+    double          parse_time;     // time spent in the parser
+    double          response_time;  // from the first response byte to the end of the response
+} resp_t;
+
+static double elapsed(const struct timespec * start, const struct timespec * end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/// See `skip_response_headers` in sunrise-sunset.c
+static const char * skip_response_headers(const char * data, const char * end, resp_t * resp)
+{
+    while (data < end && resp->state < HEADERS_SKIPPED) {
+        switch (resp->state) {
+            case SKIPPING_RESPONSE_HEADER:      if (*data == '\r') resp->state = RESPONSE_HEADER_TERM_CR_FOUND; break;
+            case RESPONSE_HEADER_TERM_CR_FOUND: if (*data == '\n') resp->state = RESPONSE_HEADER_TERM_LF_FOUND; break;
+            case RESPONSE_HEADER_TERM_LF_FOUND: resp->state = *data == '\r' ? HEADERS_TERM_CR_FOUND : SKIPPING_RESPONSE_HEADER; break;
+            case HEADERS_TERM_CR_FOUND:         if (*data == '\n') resp->state = HEADERS_SKIPPED; break;
+        }
+        ++data;
+    }
+    return data;
+}
+
+static void handle_response(const char * data, uint16_t size, void * cb_data)
+{
+    resp_t * resp = cb_data;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (resp->state == SKIPPING_RESPONSE_HEADER && resp->first_byte.tv_sec == 0) {
+        resp->first_byte = start;
+    }
+
+    const char * data_end = data + size;
+    if (resp->state < HEADERS_SKIPPED) {
+        data = skip_response_headers(data, data_end, resp);
+        if (resp->state < HEADERS_SKIPPED) {
+            return;
+        }
+    }
+    if (resp->state >= DONE) {
+        return;
+    }
+
+    uint8_t token;
+    if (resp->state == HEADERS_SKIPPED) {
+        resp->state = PARSING;
+        token = jspp_start(&resp->json_parser, data, data_end - data);
+    } else {
+        token = jspp_continue(&resp->json_parser, data, data_end - data);
+    }
+    while (token > JSON_CONTINUE) {
+        ++resp->num_tokens;
+        token = jspp_next(&resp->json_parser);
+    }
+    if (token == JSON_END) {
+        resp->state = DONE;
+    } else if (token != JSON_CONTINUE) {
+        resp->state = PARSING_FAILED;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    resp->parse_time += elapsed(&start, &end);
+    if (resp->state == DONE) {
+        resp->response_time = elapsed(&resp->first_byte, &end);
+    }
+}
+
+/// Serves the canned response to every connection until it is killed
+static void serve(int server)
+{
+    char buf[1024];
+    for (;;) {
+        int sock = accept(server, NULL, NULL);
+        if (sock < 0) {
+            continue;
+        }
+        // read the request up to the empty line
+        int received = 0;
+        while (received < (int) sizeof(buf) - 1) {
+            int n = read(sock, buf + received, sizeof(buf) - 1 - received);
+            if (n <= 0) {
+                break;
+            }
+            received += n;
+            buf[received] = '\0';
+            if (strstr(buf, "\r\n\r\n")) {
+                break;
+            }
+        }
+        for (int sent = 0, n; sent < (int) sizeof(response) - 1; sent += n) {
+            n = write(sock, response + sent, sizeof(response) - 1 - sent);
+            if (n <= 0) {
+                break;
+            }
+        }
+        close(sock);
+    }
+}
+
+static int compare_doubles(const void * a, const void * b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+    return x < y ? -1 : x > y;
+}
+
+static void print_percentiles(const char * name, double * values, unsigned count)
+{
+    qsort(values, count, sizeof(double), compare_doubles);
+    printf("%-14s p50 %8.1f us   p90 %8.1f us   p99 %8.1f us   max %8.1f us\n", name,
+        values[count / 2] * 1e6, values[count * 9 / 10] * 1e6, values[count * 99 / 100] * 1e6, values[count - 1] * 1e6);
+}
+
+int main(int argc, char * argv[])
+{
+    unsigned num_requests = 10000;
+    unsigned max_connections = 256;
+    unsigned read_size = 256;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:c:r:")) != -1) {
+        switch (opt) {
+            case 'n': num_requests = atoi(optarg); break;
+            case 'c': max_connections = atoi(optarg); break;
+            case 'r': read_size = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-n requests] [-c connections] [-r read size]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (num_requests == 0 || read_size == 0 || read_size > 65535) {
+        fprintf(stderr, "invalid arguments\n");
+        return 1;
+    }
+
+    // start the loopback server on an ephemeral port
+    int server = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = 0 };
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    if (server < 0
+        || bind(server, (struct sockaddr *) &addr, sizeof(addr)) < 0
+        || listen(server, 4096) < 0
+        || getsockname(server, (struct sockaddr *) &addr, &addr_len) < 0
+    ) {
+        perror("server");
+        return 1;
+    }
+    pid_t server_pid = fork();
+    if (server_pid == 0) {
+        serve(server);
+        return 0;
+    }
+    close(server);
+
+    http_fetch_t * fetches = calloc(num_requests, sizeof(http_fetch_t));
+    resp_t * resps = calloc(num_requests, sizeof(resp_t));
+    double * times = calloc(num_requests, sizeof(double));
+    for (unsigned i = 0; i < num_requests; i++) {
+        fetches[i].request = "/json?lat=38.889411&lng=-77.0352381";
+        fetches[i].cb_data = &resps[i];
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int rc = http_fetch_all("127.0.0.1", ntohs(addr.sin_port), fetches, num_requests, max_connections, read_size, handle_response, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    kill(server_pid, SIGTERM);
+    waitpid(server_pid, NULL, 0);
+
+    if (rc != 0) {
+        fprintf(stderr, "fetch failed: %d\n", rc);
+        return 1;
+    }
+    unsigned failed = 0;
+    for (unsigned i = 0; i < num_requests; i++) {
+        if (fetches[i].rc != 0 || resps[i].state != DONE) {
+            ++failed;
+        }
+    }
+    double seconds = elapsed(&start, &end);
+    printf("%u requests, %u connections, %u byte reads: %.0f requests/s, %u failed\n",
+        num_requests, max_connections, read_size, num_requests / seconds, failed);
+
+    for (unsigned i = 0; i < num_requests; i++) {
+        times[i] = resps[i].parse_time;
+    }
+    print_percentiles("parse time", times, num_requests);
+    for (unsigned i = 0; i < num_requests; i++) {
+        times[i] = resps[i].response_time;
+    }
+    print_percentiles("response time", times, num_requests);
+
+    free(times);
+    free(resps);
+    free(fetches);
+    return failed ? 1 : 0;
+}
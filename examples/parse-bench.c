@@ -0,0 +1,192 @@
+#include <jspp.h>
+#include <jspp_conv.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DOCUMENT_SIZE   (8 * 1024 * 1024)
+#define FRAGMENT_SIZE   512
+
+/// Writes a JSON array of objects that resemble a typical web service response
+static size_t generate_records(char * doc, size_t size, const char * indent, const char * space)
+{
+    size_t len = sprintf(doc, "[%s", indent);
+    for (unsigned i = 0; len < size - 1024; i++) {
+        len += sprintf(doc + len,
+            "%s{%s\"id\":%s%u,%s\"name\":%s\"item %u\",%s\"price\":%s%u.%02u,%s\"tags\":%s[\"a\",%s\"b\"],%s"
+            "\"location\":%s{\"lat\":%s%d.%06u,%s\"lng\":%s%d.%06u},%s\"active\":%s%s,%s\"note\":%snull}",
+            i ? "," : "", indent, space, i, indent, space, i, indent, space, i % 1000, i % 100, indent, space, space, indent,
+            space, space, (int) (i % 180) - 90, i % 1000000, space, space, (int) (i % 360) - 180, (i * 7) % 1000000,
+            indent, space, i % 2 ? "true" : "false", indent, space);
+    }
+    len += sprintf(doc + len, "%s]", indent);
+    return len;
+}
+
+/// Writes a JSON array of long strings, like a log or a list of messages
+static size_t generate_strings(char * doc, size_t size)
+{
+    size_t len = sprintf(doc, "[");
+    for (unsigned i = 0; len < size - 1024; i++) {
+        len += sprintf(doc + len, "%s\"%u: The quick brown fox jumps over the lazy dog. The \\\"lazy\\\" dog sleeps.\"",
+            i ? "," : "", i);
+    }
+    len += sprintf(doc + len, "]");
+    return len;
+}
+
+/// Writes a flat JSON array of coordinates, like the ones of a GeoJSON line string or a metric series
+static size_t generate_coordinates(char * doc, size_t size)
+{
+    size_t len = sprintf(doc, "[");
+    for (unsigned i = 0; len < size - 1024; i++) {
+        len += sprintf(doc + len, "%s%d.%06u,%d.%06u", i ? "," : "", (int) (i % 360) - 180, (i * 7) % 1000000,
+            (int) (i % 180) - 90, (i * 13) % 1000000);
+    }
+    len += sprintf(doc + len, "]");
+    return len;
+}
+
+// Member name options
+#define PLAIN   0
+#define INTERN  1 ///< Intern member names
+#define SHAPE   2 ///< Predict member names of records
+
+static double run(const char * name, const char * doc, size_t size, int options)
+{
+    jspp_intern_entry_t entries[64];
+    char names[1024];
+    jspp_intern_t table;
+    jspp_shape_t shape;
+
+    double best = 0;
+    unsigned long num_tokens = 0;
+    for (int run = 0; run < 5; run++) {
+        jspp_t parser;
+        size_t pos = FRAGMENT_SIZE;
+        num_tokens = 0;
+
+        clock_t start = clock();
+        uint8_t token = jspp_start(&parser, doc, FRAGMENT_SIZE);
+        if (options & INTERN) {
+            jspp_intern_init(&table, entries, 64, names, sizeof(names));
+            jspp_set_intern(&parser, &table);
+        }
+        if (options & SHAPE) {
+            jspp_shape_init(&shape, 2);
+            jspp_set_shape(&parser, &shape);
+        }
+        for (;;) {
+            if (token == JSON_CONTINUE) {
+                uint16_t len = size - pos < FRAGMENT_SIZE ? size - pos : FRAGMENT_SIZE;
+                token = jspp_continue(&parser, doc + pos, len);
+                pos += len;
+            } else if (token > JSON_CONTINUE) {
+                ++num_tokens;
+                token = jspp_next(&parser);
+            } else {
+                break;
+            }
+        }
+        double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+        if (token != JSON_END) {
+            printf("%-16s failed (token=%u)\n", name, token);
+            return 0;
+        }
+        if (run == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    printf("%-16s %8.1f MB/s  %lu tokens", name, size / best / 1e6, num_tokens);
+    if (options & SHAPE) {
+        printf(", %.1f%% of names predicted", 100.0 * shape.hits / (shape.hits + shape.misses));
+    }
+    printf("\n");
+    return best;
+}
+
+#define NUMBERS_SIZE 256
+
+/// Converts the numbers of the array either one token at a time or with `jspp_read_number_array`
+static double run_numbers(const char * name, const char * doc, size_t size, int bulk)
+{
+    double best = 0;
+    double sum = 0;
+    unsigned long num_numbers = 0;
+    for (int run = 0; run < 5; run++) {
+        jspp_t parser;
+        jspp_number_reader_t reader;
+        double numbers[NUMBERS_SIZE];
+        char part[64];
+        uint16_t part_length = 0;
+        size_t pos = FRAGMENT_SIZE;
+        num_numbers = 0;
+        sum = 0;
+
+        clock_t start = clock();
+        jspp_number_reader_init(&reader);
+        uint8_t token = jspp_start(&parser, doc, FRAGMENT_SIZE);
+        for (;;) {
+            if (token == JSON_CONTINUE) {
+                uint16_t len = size - pos < FRAGMENT_SIZE ? size - pos : FRAGMENT_SIZE;
+                token = jspp_continue(&parser, doc + pos, len);
+                pos += len;
+            } else if (bulk && (token == JSON_ARRAY_BEGIN || token == JSON_NUMBER_PART || (JSON_INTEGER <= token && token <= JSON_FLOATING_POINT))) {
+                uint32_t count = jspp_read_number_array(&parser, &reader, numbers, NUMBERS_SIZE);
+                for (uint32_t i = 0; i < count; i++) {
+                    sum += numbers[i];
+                }
+                num_numbers += count;
+                token = parser.token;
+            } else if (token == JSON_NUMBER_PART || (JSON_INTEGER <= token && token <= JSON_FLOATING_POINT)) {
+                uint16_t length;
+                const char * text = jspp_text(&parser, &length);
+                memcpy(part + part_length, text, length);
+                part_length += length;
+                if (token != JSON_NUMBER_PART) {
+                    jspp_scan_double(part, part_length, numbers);
+                    sum += numbers[0];
+                    ++num_numbers;
+                    part_length = 0;
+                }
+                token = jspp_next(&parser);
+            } else if (token > JSON_CONTINUE) {
+                token = jspp_next(&parser);
+            } else {
+                break;
+            }
+        }
+        double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+        if (token != JSON_END) {
+            printf("%-16s failed (token=%u)\n", name, token);
+            return 0;
+        }
+        if (run == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    printf("%-16s %8.1f MB/s  %lu numbers, sum %.6f\n", name, size / best / 1e6, num_numbers, sum);
+    return best;
+}
+
+int main()
+{
+    char * doc = malloc(DOCUMENT_SIZE);
+    if (!doc) {
+        return 1;
+    }
+    size_t size = generate_records(doc, DOCUMENT_SIZE, "\n    ", " ");
+    run("pretty", doc, size, PLAIN);
+    size = generate_records(doc, DOCUMENT_SIZE, "", "");
+    run("compact", doc, size, PLAIN);
+    run("compact, intern", doc, size, INTERN);
+    run("compact, shape", doc, size, INTERN | SHAPE);
+    size = generate_strings(doc, DOCUMENT_SIZE);
+    run("strings", doc, size, PLAIN);
+    size = generate_coordinates(doc, DOCUMENT_SIZE);
+    run_numbers("numbers", doc, size, 0);
+    run_numbers("numbers, bulk", doc, size, 1);
+    free(doc);
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <jspp_pipeline.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+#define NUM_BUFFERS 8
+#define BUFFER_SIZE 4096
+
+static jspp_pipeline_t pipeline;
+static char buffers[NUM_BUFFERS][BUFFER_SIZE];
+static atomic_int parser_done;
+
+typedef struct _reader {
+    int         fd;
+    uint64_t    num_bytes;
+    uint64_t    num_stalls; // how many times the reader had to wait for a free buffer
+} reader_t;
+
+/// The reader thread - receives fragments and passes them to the parser
+static void * read_fragments(void * arg)
+{
+    reader_t * reader = arg;
+    for (;;) {
+        char * buffer;
+        while ((buffer = jspp_pipeline_acquire(&pipeline)) == NULL) {
+            if (atomic_load(&parser_done)) {
+                // the parser has stopped (JSON ended before the input or it is invalid)
+                return NULL;
+            }
+            // all the buffers are waiting for the parser
+            ++reader->num_stalls;
+            sched_yield();
+        }
+        int size = read(reader->fd, buffer, BUFFER_SIZE);
+        if (size <= 0) {
+            jspp_pipeline_publish(&pipeline, buffer, 0);
+            return NULL;
+        }
+        reader->num_bytes += size;
+        jspp_pipeline_publish(&pipeline, buffer, size);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    reader_t reader = { 0 };
+    reader.fd = argc > 1 ? open(argv[1], O_RDONLY) : 0;
+    if (reader.fd < 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    jspp_pipeline_init(&pipeline, buffers[0], NUM_BUFFERS, BUFFER_SIZE);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pthread_t reader_thread;
+    if (pthread_create(&reader_thread, NULL, read_fragments, &reader) != 0) {
+        perror("pthread_create");
+        return 1;
+    }
+
+    // This thread is the parser
+    uint64_t num_tokens = 0;
+    uint64_t num_waits = 0;
+    uint8_t token;
+    while ((token = jspp_pipeline_next(&pipeline)) != JSON_END) {
+        if (token == JSON_CONTINUE) {
+            // the reader has not published the next fragment yet
+            ++num_waits;
+            sched_yield();
+        } else if (token == JSON_INVALID || token == JSON_TOO_DEEP) {
+            break;
+        } else {
+            ++num_tokens;
+            // Text of the token is valid until the next `jspp_pipeline_next` call:
+            // uint16_t length;
+            // const char * text = jspp_text(&pipeline.parser, &length);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    atomic_store(&parser_done, 1);
+    pthread_join(reader_thread, NULL);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%s: %llu tokens, %llu bytes, %.1f MB/s\n", token == JSON_END ? "done" : "failed",
+        (unsigned long long) num_tokens, (unsigned long long) reader.num_bytes, reader.num_bytes / seconds / 1e6);
+    printf("parser waited for fragments %llu times, reader waited for buffers %llu times\n",
+        (unsigned long long) num_waits, (unsigned long long) reader.num_stalls);
+    return token == JSON_END ? 0 : 1;
+}
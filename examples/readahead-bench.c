@@ -0,0 +1,138 @@
+#include <readahead.h>
+#include <jspp.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+/// Parser state that is carried from one fragment to the next
+typedef struct _counter {
+    jspp_t      parser;
+    uint8_t     started;
+    uint8_t     token;      // the last token returned by the parser
+    uint64_t    num_tokens;
+    uint64_t    num_parts;  // tokens that were split between fragments
+} counter_t;
+
+/**
+ * \brief Parses the fragment and counts the tokens.
+ *
+ * Note that when this callback returns the parser has reached the end of the fragment (`JSON_CONTINUE`),
+ * so it no longer references the fragment buffer and the reader is free to reuse it.
+ */
+static void count_tokens(const char * data, uint16_t size, void * cb_data)
+{
+    counter_t * counter = cb_data;
+    uint8_t token;
+    if (!counter->started) {
+        counter->started = 1;
+        token = jspp_start(&counter->parser, data, size);
+    } else if (counter->token == JSON_CONTINUE) {
+        token = jspp_continue(&counter->parser, data, size);
+    } else {
+        return; // done or failed
+    }
+    while (token > JSON_CONTINUE) {
+        if (token != JSON_MEMBER_NAME_PART && token != JSON_STRING_PART && token != JSON_NUMBER_PART) {
+            ++counter->num_tokens;
+        } else {
+            ++counter->num_parts;
+        }
+        token = jspp_next(&counter->parser);
+    }
+    counter->token = token;
+}
+
+/// Writes a JSON array of objects that resemble a typical web service response
+static int generate(const char * path, unsigned size_mb)
+{
+    FILE * f = fopen(path, "w");
+    if (!f) {
+        return 1;
+    }
+    fputs("[\n", f);
+    unsigned long written = 2;
+    for (unsigned i = 0; written < size_mb * 1024ul * 1024ul; i++) {
+        written += fprintf(f,
+            "%s  { \"id\": %u, \"name\": \"item %u\", \"price\": %u.%02u, \"tags\": [ \"a\", \"b\" ],\n"
+            "    \"location\": { \"lat\": %d.%06u, \"lng\": %d.%06u }, \"active\": %s, \"note\": null }",
+            i ? ",\n" : "", i, i, i % 1000, i % 100, (int) (i % 180) - 90, i % 1000000, (int) (i % 360) - 180, (i * 7) % 1000000,
+            i % 2 ? "true" : "false");
+    }
+    fputs("\n]\n", f);
+    return fclose(f);
+}
+
+typedef int (*reader_t)(int fd, unsigned param, read_cb_t callback, void * callback_data);
+
+static int sync_reader(int fd, unsigned buffer_size, read_cb_t callback, void * callback_data)
+{
+    return read_sync(fd, buffer_size, callback, callback_data);
+}
+
+static int ahead_reader(int fd, unsigned num_buffers, read_cb_t callback, void * callback_data)
+{
+    static char buffers[READ_AHEAD_MAX_BUFFERS * READ_AHEAD_BUFFER_SIZE];
+    return read_ahead(fd, buffers, num_buffers, callback, callback_data);
+}
+
+static int adaptive_reader(int fd, unsigned read_size, read_cb_t callback, void * callback_data)
+{
+    static char buffer[65535];
+    read_adaptive_t reader;
+    read_adaptive_init(&reader, buffer, sizeof(buffer), read_size);
+    return read_adaptive(fd, &reader, callback, callback_data);
+}
+
+static void run(const char * path, const char * name, reader_t reader, unsigned param)
+{
+    double best = 0;
+    counter_t counter;
+    off_t size = 0;
+    for (int run = 0; run < 5; run++) {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            perror(path);
+            return;
+        }
+        size = lseek(fd, 0, SEEK_END);
+        lseek(fd, 0, SEEK_SET);
+        memset(&counter, 0, sizeof(counter));
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int rc = reader(fd, param, count_tokens, &counter);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        close(fd);
+        if (rc || counter.token != JSON_END) {
+            printf("%-24s failed (rc=%d, token=%u)\n", name, rc, counter.token);
+            return;
+        }
+        double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        if (run == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    printf("%-24s %8.1f MB/s  %llu tokens  %llu parts\n", name, size / best / 1e6, (unsigned long long) counter.num_tokens,
+        (unsigned long long) counter.num_parts);
+}
+
+int main(int argc, char * argv[])
+{
+    const char * path = argc > 1 ? argv[1] : "readahead-bench.json";
+    if (access(path, R_OK) != 0) {
+        printf("generating %s\n", path);
+        if (generate(path, 64) != 0) {
+            perror(path);
+            return 1;
+        }
+    }
+    run(path, "read, 256 B buffer", sync_reader, 256);
+    run(path, "read, 16 KB buffer", sync_reader, READ_AHEAD_BUFFER_SIZE);
+    run(path, "adaptive, 256 B start", adaptive_reader, 256);
+    run(path, "io_uring, 2 buffers", ahead_reader, 2);
+    run(path, "io_uring, 4 buffers", ahead_reader, 4);
+    run(path, "io_uring, 8 buffers", ahead_reader, 8);
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <jspp.h>
+#include <jspp_select.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LOG_SIZE        (64 * 1024 * 1024)
+#define BUFFER_SIZE     (64 * 1024)
+
+static const char * const levels[] = { "debug", "info", "info", "info", "warning" };
+
+/// Writes NDJSON log records. Every 100th record is an error.
+static size_t generate_log(char * log, size_t size)
+{
+    size_t len = 0;
+    for (unsigned i = 0; len < size - 1024; i++) {
+        len += sprintf(log + len,
+            "{\"ts\":%u,\"level\":\"%s\",\"service\":\"api-%u\",\"status\":%u,\"latency\":%u.%03u,"
+            "\"msg\":\"request %u has been handled, no error\",\"tags\":[\"web\",\"v2\"]}\n",
+            1700000000 + i, i % 100 == 0 ? "error" : levels[i % 5], i % 16, i % 100 == 0 ? 500 : 200, i % 300, i % 1000, i);
+    }
+    return len;
+}
+
+static void count_record(const char * record, uint32_t length, void * cb_data)
+{
+    (void) record;
+    (void) length;
+    ++*(unsigned long *) cb_data;
+}
+
+/// Counts the records with `memchr` - the speed limit for anything that has to find the records
+static unsigned long count_lines(const char * log, size_t size)
+{
+    unsigned long count = 0;
+    const char * end = log + size;
+    for (const char * lf = log; (lf = memchr(lf, '\n', end - lf)) != NULL; lf++) {
+        ++count;
+    }
+    return count;
+}
+
+/// Parses every record and checks the values of its top level `level` and `status` members
+static unsigned long parse_all(const char * log, size_t size)
+{
+    unsigned long count = 0;
+    const char * end = log + size;
+    for (const char * record = log; record < end; ) {
+        const char * lf = memchr(record, '\n', end - record);
+        jspp_t parser;
+        uint8_t token = jspp_start(&parser, record, lf - record);
+        int matched = 0;
+        int depth = 0;
+        const char * name = NULL;
+        uint16_t name_length = 0;
+        while (token > JSON_CONTINUE) {
+            uint16_t length;
+            const char * text = jspp_text(&parser, &length);
+            if (token == JSON_OBJECT_BEGIN || token == JSON_ARRAY_BEGIN) {
+                ++depth;
+            } else if (token == JSON_OBJECT_END || token == JSON_ARRAY_END) {
+                --depth;
+            } else if (token == JSON_MEMBER_NAME && depth == 1) {
+                name = text;
+                name_length = length;
+            } else if (depth == 1 && name) {
+                if ((name_length == 5 && memcmp(name, "level", 5) == 0 && token == JSON_STRING && length == 5
+                        && memcmp(text, "error", 5) == 0)
+                    || (name_length == 6 && memcmp(name, "status", 6) == 0 && length == 3 && memcmp(text, "500", 3) == 0)) {
+                    ++matched;
+                }
+                name = NULL;
+            }
+            token = jspp_next(&parser);
+        }
+        if (matched == 2) {
+            ++count;
+        }
+        record = lf + 1;
+    }
+    return count;
+}
+
+/// Passes the log to the selector in buffers, like it would be read from a file or a socket
+static unsigned long select_records(const char * log, size_t size, uint64_t * candidates)
+{
+    static const jspp_predicate_t predicates[] = {
+        { "level", "\"error\"" },
+        { "status", "500" },
+    };
+    unsigned long count = 0;
+    jspp_select_t select;
+    jspp_select_init(&select, predicates, 2, count_record, &count);
+    size_t pos = 0;
+    while (pos < size) {
+        uint32_t len = size - pos < BUFFER_SIZE ? size - pos : BUFFER_SIZE;
+        pos += jspp_select_records(&select, log + pos, len, pos + len == size);
+    }
+    *candidates = select.candidates;
+    return count;
+}
+
+typedef struct _timing {
+    double          seconds;
+    unsigned long   count;
+} timing_t;
+
+static void report(const char * name, size_t size, timing_t timing, const char * unit)
+{
+    printf("%-12s %8.1f MB/s  %lu %s\n", name, size / timing.seconds / 1e6, timing.count, unit);
+}
+
+int main()
+{
+    char * log = malloc(LOG_SIZE);
+    if (!log) {
+        return 1;
+    }
+    size_t size = generate_log(log, LOG_SIZE);
+    timing_t lines = { 0 }, parse = { 0 }, select = { 0 };
+    uint64_t candidates = 0;
+    for (int run = 0; run < 5; run++) {
+        timing_t t;
+        clock_t start = clock();
+        t.count = count_lines(log, size);
+        t.seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+        if (run == 0 || t.seconds < lines.seconds) lines = t;
+
+        start = clock();
+        t.count = parse_all(log, size);
+        t.seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+        if (run == 0 || t.seconds < parse.seconds) parse = t;
+
+        start = clock();
+        t.count = select_records(log, size, &candidates);
+        t.seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+        if (run == 0 || t.seconds < select.seconds) select = t;
+    }
+    report("memchr", size, lines, "records");
+    report("parse all", size, parse, "selected");
+    report("select", size, select, "selected");
+    printf("%-12s %llu of %lu records parsed\n", "", (unsigned long long) candidates, lines.count);
+    free(log);
+    return parse.count != select.count;
+}
@@ -0,0 +1,246 @@
+#include <jspp.h>
+#include <jspp_index.h>
+#include <jspp_writer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAGMENT_SIZE   65535
+
+static const char magic[8] = { 'J', 'S', 'P', 'P', 'I', 'D', 'X', '1' };
+
+static char fragment[FRAGMENT_SIZE];
+
+static void put_uint(FILE * file, uint64_t value, int size)
+{
+    for (int i = 0; i < size; i++, value >>= 8) {
+        fputc((int) (value & 0xff), file);
+    }
+}
+
+static int get_uint(FILE * file, uint64_t * value, int size)
+{
+    *value = 0;
+    for (int i = 0; i < size; i++) {
+        int c = fgetc(file);
+        if (c == EOF) {
+            return 0;
+        }
+        *value |= (uint64_t) c << (i * 8);
+    }
+    return 1;
+}
+
+/// Sidecar file name
+static const char * index_name(const char * json_name)
+{
+    static char name[1024];
+    snprintf(name, sizeof(name), "%s.idx", json_name);
+    return name;
+}
+
+static void write_entry(uint8_t path, uint64_t element, const uint8_t * checkpoint, uint16_t size, void * cb_data)
+{
+    FILE * idx = cb_data;
+    fputc(path, idx);
+    put_uint(idx, element, 8);
+    put_uint(idx, size, 2);
+    fwrite(checkpoint, 1, size, idx);
+}
+
+/**
+ * \brief Parses the entire JSON file and writes the checkpoints into the sidecar file.
+ *
+ * Sidecar format (integers are little-endian):
+ * - magic "JSPPIDX1", interval (4 bytes), number of paths (1 byte), each path as the length (2 bytes) and the text
+ * - entries: path index (1 byte), element index (8 bytes), checkpoint size (2 bytes) and the checkpoint
+ */
+static int build(const char * json_name, uint32_t interval, const char * const * paths, int num_paths)
+{
+    FILE * json = fopen(json_name, "rb");
+    if (!json) {
+        perror(json_name);
+        return 1;
+    }
+    FILE * idx = fopen(index_name(json_name), "wb");
+    if (!idx) {
+        perror(index_name(json_name));
+        fclose(json);
+        return 1;
+    }
+    fwrite(magic, 1, sizeof(magic), idx);
+    put_uint(idx, interval, 4);
+    fputc(num_paths, idx);
+    for (int i = 0; i < num_paths; i++) {
+        put_uint(idx, strlen(paths[i]), 2);
+        fwrite(paths[i], 1, strlen(paths[i]), idx);
+    }
+
+    jspp_index_t index;
+    jspp_index_init(&index, paths, interval, write_entry, idx);
+    uint8_t token = JSON_CONTINUE;
+    size_t size;
+    while (token == JSON_CONTINUE && (size = fread(fragment, 1, sizeof(fragment), json)) > 0) {
+        token = jspp_index_feed(&index, fragment, size);
+    }
+    fclose(json);
+    fclose(idx);
+    if (token != JSON_END) {
+        fprintf(stderr, "%s: JSON is %s\n", json_name, token == JSON_CONTINUE ? "truncated" : "not valid");
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * \brief Finds the checkpoint for the value at the path or for its array element.
+ *
+ * \return The element index of the found checkpoint. `checkpoint_size` remains 0 if there is none.
+ */
+static uint64_t find_checkpoint(FILE * idx, const char * path, uint64_t element, uint8_t * checkpoint, uint16_t * checkpoint_size)
+{
+    char header[sizeof(magic)];
+    if (fread(header, 1, sizeof(header), idx) != sizeof(header) || memcmp(header, magic, sizeof(magic)) != 0) {
+        return JSPP_INDEX_VALUE;
+    }
+    uint64_t val;
+    get_uint(idx, &val, 4);
+    int num_paths = fgetc(idx);
+    int path_index = -1;
+    for (int i = 0; i < num_paths; i++) {
+        char name[1024];
+        if (!get_uint(idx, &val, 2) || val >= sizeof(name) || fread(name, 1, val, idx) != val) {
+            return JSPP_INDEX_VALUE;
+        }
+        if (val == strlen(path) && memcmp(name, path, val) == 0) {
+            path_index = i;
+        }
+    }
+
+    uint64_t found = JSPP_INDEX_VALUE;
+    uint8_t entry[JSPP_CHECKPOINT_SIZE];
+    int entry_path;
+    while ((entry_path = fgetc(idx)) != EOF) {
+        uint64_t entry_element, size;
+        if (!get_uint(idx, &entry_element, 8) || !get_uint(idx, &size, 2) || size > sizeof(entry)
+            || fread(entry, 1, size, idx) != size) {
+            break;
+        }
+        if (entry_path != path_index) {
+            continue;
+        }
+        if (element != JSPP_INDEX_VALUE && entry_element != JSPP_INDEX_VALUE && entry_element > element) {
+            // the entries of an array are in the element order
+            break;
+        }
+        // the value itself when the element is not specified, or the nearest preceding element checkpoint
+        if (element == JSPP_INDEX_VALUE ? entry_element == JSPP_INDEX_VALUE
+            : entry_element <= element && (found == JSPP_INDEX_VALUE || entry_element > found)) {
+            found = entry_element;
+            memcpy(checkpoint, entry, size);
+            *checkpoint_size = size;
+            if (element == JSPP_INDEX_VALUE) {
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+static void print(const char * data, uint16_t size, void * flush_data)
+{
+    fwrite(data, 1, size, flush_data);
+}
+
+/// Resumes parsing at the checkpoint and prints the JSON element
+static int get(const char * json_name, const char * path, uint64_t element)
+{
+    FILE * idx = fopen(index_name(json_name), "rb");
+    if (!idx) {
+        perror(index_name(json_name));
+        return 1;
+    }
+    uint8_t checkpoint[JSPP_CHECKPOINT_SIZE];
+    uint16_t checkpoint_size = 0;
+    uint64_t found = find_checkpoint(idx, path, element, checkpoint, &checkpoint_size);
+    fclose(idx);
+    if (checkpoint_size == 0) {
+        fprintf(stderr, "%s is not indexed\n", path);
+        return 1;
+    }
+
+    jspp_t parser;
+    jspp_search_t search;
+    uint64_t offset;
+    if (jspp_restore(&parser, checkpoint, checkpoint_size, &offset) != JSON_CONTINUE) {
+        fprintf(stderr, "%s is damaged\n", index_name(json_name));
+        return 1;
+    }
+    FILE * json = fopen(json_name, "rb");
+    if (!json) {
+        perror(json_name);
+        return 1;
+    }
+    fseeko(json, offset, SEEK_SET);
+
+    uint8_t token = JSON_CONTINUE;
+    if (element != JSPP_INDEX_VALUE) {
+        token = jspp_seek_index(&parser, &search, element - found);
+    }
+
+    char buffer[1024];
+    jspp_writer_t writer;
+    jspp_writer_init(&writer, buffer, sizeof(buffer), print, stdout);
+    uint64_t parsed = 0;
+    int done = 0;
+    while (!done) {
+        if (token == JSON_CONTINUE) {
+            size_t size = fread(fragment, 1, sizeof(fragment), json);
+            if (size == 0) {
+                break;
+            }
+            parsed += size;
+            token = jspp_continue(&parser, fragment, size);
+            continue;
+        }
+        if (token <= JSON_END || (token == JSON_ARRAY_END && writer.level == 0)) {
+            // past the end of the array
+            break;
+        }
+        uint16_t length;
+        const char * text = jspp_text(&parser, &length);
+        jspp_write_raw(&writer, token, text, length);
+        done = writer.level == 0 && token != JSON_STRING_PART && token != JSON_NUMBER_PART;
+        if (!done) {
+            token = jspp_next(&parser);
+        }
+    }
+    jspp_write_flush(&writer);
+    fclose(json);
+    if (!done) {
+        fprintf(stderr, "not found\n");
+        return 1;
+    }
+    printf("\n");
+    fprintf(stderr, "resumed at offset %llu, read %llu bytes\n", (unsigned long long) offset, (unsigned long long) parsed);
+    return 0;
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc >= 5 && strcmp(argv[1], "build") == 0) {
+        if (argc - 4 > JSPP_INDEX_MAX_PATHS) {
+            fprintf(stderr, "too many paths\n");
+            return 1;
+        }
+        // paths are followed by argv's terminating NULL
+        return build(argv[2], strtoul(argv[3], NULL, 10), (const char * const *) argv + 4, argc - 4);
+    }
+    if ((argc == 4 || argc == 5) && strcmp(argv[1], "get") == 0) {
+        return get(argv[2], argv[3], argc == 5 ? strtoull(argv[4], NULL, 10) : JSPP_INDEX_VALUE);
+    }
+    fprintf(stderr,
+        "usage: %s build <file> <interval> <path>...\n"
+        "       %s get <file> <path> [<element>]\n", argv[0], argv[0]);
+    return 1;
+}
@@ -1,4 +1,5 @@
 #include <httpget.h>
+#include <httpresp.h>
 #include <jspp.h>
 #include <stdio.h>
 #include <string.h>
@@ -50,11 +51,7 @@ typedef struct _ws_resp {
 } sunset_sunrize_resp_t;
 
 enum _ws_resp_states {
-    SKIPPING_RESPONSE_HEADER = 0, // this way it is "set" automaticaly by calloc
-    RESPONSE_HEADER_TERM_CR_FOUND,
-    RESPONSE_HEADER_TERM_LF_FOUND,
-    HEADERS_TERM_CR_FOUND,
-    HEADERS_SKIPPED,
+    EXPECTING_PAYLOAD = 0, // this way it is "set" automaticaly by calloc
     EXPECTING_RESULTS,
     EXPECTING_RESULTS_OBJECT,
     EXPECTING_DATA_NAME,
@@ -112,53 +109,6 @@ static ws_time_t scan_time(const char * str, uint16_t len)
     return (ws_time_t){s, m, h};
 }
 
-/**
- * \brief Skips response headers.
- *
- * \param data    Pointer to the first byte of the data fragment
- * \param end     The end-of-fragment pointer
- * \param ws_resp Pointer to the WS response handling state machine
- *
- * \return The pointer to the first payload (JSON) byte. Or, if
- *         the end of headers is not encountered in the current
- *         fragment, returns the end-of-fragment pointer.
- */
-static const char * skip_response_headers(const char * data, const char * end, sunset_sunrize_resp_t * ws_resp)
-{
-    while (data < end && ws_resp->state < HEADERS_SKIPPED) {
-        switch (ws_resp->state) {
-            case SKIPPING_RESPONSE_HEADER: {
-                if (*data == '\r') {
-                    ws_resp->state = RESPONSE_HEADER_TERM_CR_FOUND;
-                }
-                break;
-            }
-            case RESPONSE_HEADER_TERM_CR_FOUND: {
-                if (*data == '\n') {
-                    ws_resp->state = RESPONSE_HEADER_TERM_LF_FOUND;
-                }
-                break;
-            }
-            case RESPONSE_HEADER_TERM_LF_FOUND: {
-                if (*data == '\r') {
-                    ws_resp->state = HEADERS_TERM_CR_FOUND;
-                } else {
-                    ws_resp->state = SKIPPING_RESPONSE_HEADER;
-                }
-                break;
-            }
-            case HEADERS_TERM_CR_FOUND: {
-                if (*data == '\n') {
-                    ws_resp->state = HEADERS_SKIPPED;
-                }
-                break;
-            }
-        }
-        ++data;
-    }
-    return data;
-}
-
 /**
  * \brief Checks whether the specified tocken matches the expected one.
  *
@@ -220,27 +170,21 @@ static const char * expected(uint8_t token, uint8_t expected, uint8_t next_state
 }
 
 /**
- * \brief Handles incoming response fragments.
+ * \brief Handles incoming response payload fragments.
  *
  * \param data    Pointer to the first byte of the data fragment
  * \param size    The size of the data in the current fragment
  * \param ws_resp Pointer to the WS call processing state machine
  *
- * The handler initially skips response headers. Because "http_get" sends 1.0 requests
- * (to avoid dealing with chunked data as that "library" designed to only serve this
- * example :) there is nothing interesting or useful we can find in those headers.
+ * The handler receives only the response body. The status line, the headers and the chunk
+ * framing of the HTTP/1.1 response are removed by the `http_resp` decoder, which passes each
+ * chunk as is. Thus a chunk boundary is just another fragment boundary for the parser.
  *
- * Once JSON payload is encountered this handler would start the parser and extract the
- * data it is interesed in - the today's twilight times.
+ * The first payload fragment starts the parser. The handler then extracts the data it is
+ * interesed in - the today's twilight times.
  */
 static void handle_ws_response(const char * data, uint16_t size, sunset_sunrize_resp_t * ws_resp)
 {
-    const char * end = data + size;
-    if (ws_resp->state < HEADERS_SKIPPED) {
-        data = skip_response_headers(data, end, ws_resp);
-        size = end - data;
-    }
-
     if (ws_resp->state >= DONE) {
         // Even though we are DONE with the data, we stil might receive more payload fragments
         return;
@@ -249,7 +193,7 @@ static void handle_ws_response(const char * data, uint16_t size, sunset_sunrize_
     jspp_t * parser = &ws_resp->json_parser;
     uint8_t token;
 
-    if (ws_resp->state == HEADERS_SKIPPED) {
+    if (ws_resp->state == EXPECTING_PAYLOAD) {
         token = jspp_start(parser, data, size);
     } else {
         token = jspp_continue(parser, data, size);
@@ -375,6 +319,7 @@ DONE:
 // We could also allocate this structure dynamically (malloc). Note that to safely dispose/return
 // those we'll need a disconnect callback from the OS/library.
 static sunset_sunrize_resp_t ws_resp;
+static http_resp_t http_resp;
 
 static void process_sunset_sunrize_data(sunset_sunrize_data_t data)
 {
@@ -396,11 +341,16 @@ int main(int argc, char * argv[])
     ws_resp.ws_data.sunset = (ws_time_t){0, 0, 0};
     ws_resp.ws_data.twilight_end = (ws_time_t) {0, 0, 0};
     ws_resp.ws_data_handler = process_sunset_sunrize_data;
-    ws_resp.state = SKIPPING_RESPONSE_HEADER;
+    ws_resp.state = EXPECTING_PAYLOAD;
     ws_resp.text_length = 0;
 
-    if (http_get("api.sunrise-sunset.org", request, (http_get_cb_t)handle_ws_response, &ws_resp) != 0) {
+    // The response is decoded by `http_resp` which passes the payload to our handler
+    http_resp_init(&http_resp, (http_resp_cb_t)handle_ws_response, NULL, &ws_resp);
+
+    if (http_get("api.sunrise-sunset.org", request, http_resp_fragment, &http_resp) != 0) {
         printf("HTTP GET failed\n");
+    } else if (http_resp_end(&http_resp) != 0) {
+        printf("Malformed HTTP response\n");
     }
     return 0;
 }
@@ -1,4 +1,7 @@
 #include "jspp.h"
+#include "jspp_conv.h"
+#include "jspp_swar.h"
+#include "jspp_probes.h"
 #include <stddef.h>
 
 // Scanner and parser states.
@@ -330,6 +333,135 @@ static inline int is_string_a_member_name(uint8_t state)
         ;
 }
 
+// Scanning shortcuts. Long runs of characters that do not change the scanner state - whitespace
+// between tokens, string characters and digits - are skipped a word at a time instead of being
+// fed to the automaton one by one. Each function returns a pointer to the first character that
+// is not a part of the run or `end`.
+
+static inline int is_whitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static const char * skip_whitespace(const char * txt, const char * end)
+{
+    if (txt == end || !is_whitespace(*txt)) {
+        // compact JSON does not have any
+        return txt;
+    }
+    while (end - txt >= (ptrdiff_t) SWAR_SIZE) {
+        swar_t word = swar_load(txt);
+        swar_t mask = swar_not_equal(word, ' ') & swar_not_equal(word, '\n')
+            & swar_not_equal(word, '\r') & swar_not_equal(word, '\t');
+        if (mask) {
+            return txt + swar_first(mask);
+        }
+        txt += SWAR_SIZE;
+    }
+    while (txt < end && is_whitespace(*txt)) {
+        ++txt;
+    }
+    return txt;
+}
+
+static const char * skip_string_chars(const char * txt, const char * end)
+{
+    while (end - txt >= (ptrdiff_t) SWAR_SIZE) {
+        swar_t word = swar_load(txt);
+        swar_t mask = swar_equal(word, '"') | swar_equal(word, '\\');
+        if (mask) {
+            return txt + swar_first(mask);
+        }
+        txt += SWAR_SIZE;
+    }
+    while (txt < end && *txt != '"' && *txt != '\\') {
+        ++txt;
+    }
+    return txt;
+}
+
+static const char * skip_digits(const char * txt, const char * end)
+{
+    while (end - txt >= (ptrdiff_t) SWAR_SIZE) {
+        // digits become 0..9 and everything else is at least 10
+        swar_t mask = swar_not_less(swar_load(txt) ^ SWAR_REPEAT('0'), 10);
+        if (mask) {
+            return txt + swar_first(mask);
+        }
+        txt += SWAR_SIZE;
+    }
+    while (txt < end && '0' <= *txt && *txt <= '9') {
+        ++txt;
+    }
+    return txt;
+}
+
+static const char * predict_member_name(jspp_t * parser, const char * txt, const char * end);
+
+/**
+ * \brief Scans ahead of the current character while the scanner state does not change.
+ *
+ * \param         parser A pointer to the parser struct
+ * \param[in,out] state The state the scanner entered after the current character
+ * \param         txt   Pointer to the current character
+ * \param         end   The end of the fragment
+ *
+ * \return Pointer to the last character that has been scanned
+ *
+ * Literals are matched as a whole when the entire literal is in the fragment. In this case the
+ * state is changed to the literal token. Member names that the shape predicts are matched as
+ * a whole too.
+ */
+static inline const char * scan_ahead(jspp_t * parser, uint8_t * state, const char * txt, const char * end)
+{
+    switch (*state) {
+        case STRING_BEGIN: {
+            if (parser->intern && parser->intern->shape) {
+                const char * name_end = predict_member_name(parser, txt, end);
+                if (name_end) {
+                    return name_end;
+                }
+            }
+            return skip_string_chars(txt + 1, end) - 1;
+        }
+        case STRING_CHARS: {
+            return skip_string_chars(txt + 1, end) - 1;
+        }
+        case INT_DIGITS:
+        case DEC_DIGITS: {
+            return skip_digits(txt + 1, end) - 1;
+        }
+        case NULL_N: {
+            if (end - txt >= 4 && swar_load32(txt) == swar_load32("null")) {
+                *state = JSON_NULL;
+                return txt + 3;
+            }
+            return txt;
+        }
+        case TRUE_T: {
+            if (end - txt >= 4 && swar_load32(txt) == swar_load32("true")) {
+                *state = JSON_TRUE;
+                return txt + 3;
+            }
+            return txt;
+        }
+        case FALSE_F: {
+            if (end - txt >= 5 && swar_load32(txt + 1) == swar_load32("alse")) {
+                *state = JSON_FALSE;
+                return txt + 4;
+            }
+            return txt;
+        }
+    }
+    if (*state >= __PARSER_STATES) {
+        return skip_whitespace(txt + 1, end) - 1;
+    }
+    return txt;
+}
+
+static void intern_member_name(jspp_t * parser, uint8_t token);
+static void track_shape(jspp_t * parser, uint8_t token);
+
 uint8_t jspp_next(jspp_t * parser)
 {
     if (parser->level >= JSON_MAX_STACK) {
@@ -356,15 +488,23 @@ uint8_t jspp_next(jspp_t * parser)
         if (is_token_start(state) || is_nested_level_start(state)) {
             set_token_start(parser, state, txt);
             if (++parser->level == JSON_MAX_STACK) {
+                JSPP_PROBE3(error, JSON_TOO_DEEP, parser->level, parser->text_offset + (txt - parser->text));
                 return JSON_TOO_DEEP;
             }
         } else if (state >= __REDUCING_PARSER_STATES) {
             set_state(parser, state);
         }
+        txt = scan_ahead(parser, &state, txt, end);
     } while (!is_final(state) && ++txt < end);
 
     uint8_t token;
-    if (is_final(state)) {
+    if (state == JSON_INVALID) {
+        // The scanner rejected the character. Keep the parser in this state, so the subsequent
+        // calls would report the same.
+        set_state(parser, state);
+        token = state;
+        JSPP_PROBE3(error, JSON_INVALID, parser->level, parser->text_offset + (txt - parser->text));
+    } else if (is_final(state)) {
         token = state;
         if (token == JSON_ARRAY_END || token == JSON_OBJECT_END) {
             // These 2 have not had their start offsets set yet. Do that now.
@@ -398,19 +538,77 @@ uint8_t jspp_next(jspp_t * parser)
         }
     }
     parser->token = token;
+    JSPP_PROBE3(token, token, parser->level, parser->token_length);
+    if (parser->intern) {
+        if (parser->intern->shape) {
+            track_shape(parser, token);
+        } else if (token == JSON_MEMBER_NAME || token == JSON_MEMBER_NAME_PART) {
+            intern_member_name(parser, token);
+        }
+    }
     return token;
 }
 
+///< Returns the index of the first character after the current token
+static inline uint16_t token_end(const jspp_t * parser)
+{
+    uint16_t end = parser->token_start + parser->token_length;
+    if (parser->token == JSON_STRING || parser->token == JSON_MEMBER_NAME) {
+        // the closing '"'
+        ++end;
+    }
+    return end;
+}
+
+///< Passes the captured text up to the `end` to the sink
+static void capture_text(jspp_t * parser, uint16_t end)
+{
+    jspp_capture_t * capture = parser->capture;
+    uint16_t start = capture->start;
+    if (!capture->begun) {
+        // whitespace and separators that precede the element
+        while (start < end && (is_whitespace(parser->text[start]) || parser->text[start] == ',' || parser->text[start] == ':')) {
+            ++start;
+        }
+    }
+    if (start < end) {
+        capture->begun = 1;
+        capture->sink(parser->text + start, end - start, capture->sink_data);
+    }
+}
+
+///< Passes the rest of the captured element to the sink when the current token is its last one
+static inline void end_capture(jspp_t * parser)
+{
+    if (parser->capture) {
+        capture_text(parser, token_end(parser));
+        parser->capture = NULL;
+    }
+}
+
+///< Finishes skipping when the current token is the last one of the skipped element
+static inline void end_skip(jspp_t * parser)
+{
+    end_capture(parser);
+    parser->skip_token = 0;
+    JSPP_PROBE2(skip__end, parser->level, parser->text_offset + token_end(parser));
+}
+
 ///< This function skips objects and arrays.
 static uint8_t skip_composite(jspp_t * parser)
 {
     uint8_t token;
     while ((token = jspp_next(parser)) != parser->skip_token || parser->level > parser->skip_level) {
-        if (token == JSON_CONTINUE) {
-            return JSON_CONTINUE;
+        if (token <= JSON_CONTINUE) {
+            if (token != JSON_CONTINUE) {
+                // the skipped element is not valid
+                parser->skip_token = 0;
+                parser->capture = NULL;
+            }
+            return token;
         }
     }
-    parser->skip_token = 0;
+    end_skip(parser);
     return jspp_next(parser);
 }
 
@@ -419,6 +617,7 @@ static uint8_t skip(jspp_t * parser, uint8_t token)
 {
     if (token <= JSON_END) {
         parser->skip_token = 0;
+        parser->capture = NULL;
         return token;
     }
     if (token <= JSON_STRING_PART) {
@@ -428,7 +627,12 @@ static uint8_t skip(jspp_t * parser, uint8_t token)
     }
     switch (token) {
         case JSON_MEMBER_NAME: {
-            return jspp_skip_next(parser);
+            if (parser->capture) {
+                // only the value is captured
+                parser->capture->start = token_end(parser);
+                parser->capture->begun = 0;
+            }
+            return skip(parser, jspp_next(parser));
         }
         case JSON_ARRAY_BEGIN: {
             parser->skip_level = parser->level - 1;
@@ -444,23 +648,437 @@ static uint8_t skip(jspp_t * parser, uint8_t token)
         case JSON_OBJECT_END: {
             // these alone should not be skipped
             parser->skip_token = 0;
+            parser->capture = NULL;
             return token;
         }
     }
-    parser->skip_token = 0;
+    end_skip(parser);
     return jspp_next(parser);
 }
 
+///< Passes the part of the captured element in the current fragment to the sink when the element continues in the next one
+static inline uint8_t capture_fragment(jspp_t * parser, uint8_t token)
+{
+    // the text of the member name, which value is captured, is not a part of the element
+    if (token == JSON_CONTINUE && parser->capture
+        && !(parser->skip_token == JSON_CONTINUE && parser->token == JSON_MEMBER_NAME_PART)) {
+        capture_text(parser, parser->text_length);
+    }
+    return token;
+}
+
 uint8_t jspp_skip_next(jspp_t * parser)
 {
+    JSPP_PROBE2(skip__begin, parser->level, parser->text_offset + token_end(parser));
     return skip(parser, jspp_next(parser));
 }
 
 uint8_t jspp_skip(jspp_t * parser)
 {
+    JSPP_PROBE2(skip__begin, parser->level, parser->text_offset + parser->token_start);
     return skip(parser, parser->token);
 }
 
+void jspp_capture_init(jspp_capture_t * capture, jspp_sink_t sink, void * sink_data)
+{
+    capture->sink = sink;
+    capture->sink_data = sink_data;
+    capture->start = 0;
+    capture->begun = 0;
+}
+
+uint8_t jspp_capture_next(jspp_t * parser, jspp_capture_t * capture)
+{
+    parser->capture = capture;
+    capture->start = token_end(parser);
+    capture->begun = 0;
+    return capture_fragment(parser, jspp_skip_next(parser));
+}
+
+///< Marks the current member name as not matching the key
+#define MEMBER_NAME_MISMATCH 0xffff
+
+///< Matches the current member name (or a part of it) against the key
+static void match_member_name(jspp_t * parser, jspp_search_t * search)
+{
+    if (search->matched == MEMBER_NAME_MISMATCH) {
+        return;
+    }
+    const char * name = parser->text + parser->token_start;
+    const char * key = search->key + search->matched;
+    uint16_t length = parser->token_length;
+    if (length > search->key_length - search->matched) {
+        search->matched = MEMBER_NAME_MISMATCH;
+        return;
+    }
+    for (uint16_t i = 0; i < length; i++) {
+        if (name[i] != key[i]) {
+            search->matched = MEMBER_NAME_MISMATCH;
+            return;
+        }
+    }
+    search->matched += length;
+}
+
+///< This function skips object members until it finds the one with the name that matches the key
+static uint8_t find_member(jspp_t * parser, uint8_t token)
+{
+    jspp_search_t * search = parser->search;
+    for (;;) {
+        switch (token) {
+            case JSON_MEMBER_NAME_PART: {
+                match_member_name(parser, search);
+                if (search->matched != MEMBER_NAME_MISMATCH) {
+                    // the rest of the name is in the next fragment
+                    return JSON_CONTINUE;
+                }
+                search->matched = 0;
+                token = jspp_skip(parser);
+                break;
+            }
+            case JSON_MEMBER_NAME: {
+                match_member_name(parser, search);
+                if (search->matched == search->key_length) {
+                    parser->search = NULL;
+                    return jspp_next(parser);
+                }
+                search->matched = 0;
+                token = jspp_skip(parser);
+                break;
+            }
+            case JSON_CONTINUE: {
+                return JSON_CONTINUE;
+            }
+            default: {
+                parser->search = NULL;
+                return token;
+            }
+        }
+    }
+}
+
+uint8_t jspp_find_member(jspp_t * parser, jspp_search_t * search, const char * key, uint16_t key_length)
+{
+    search->key = key;
+    search->key_length = key_length;
+    search->matched = 0;
+    parser->search = search;
+
+    uint8_t token = parser->token;
+    if (token != JSON_MEMBER_NAME && token != JSON_MEMBER_NAME_PART) {
+        token = jspp_next(parser);
+    }
+    return find_member(parser, token);
+}
+
+// `skip_token` hints that make `jspp_continue` resume array scanning
+#define SEEKING_INDEX       JSON_ARRAY_BEGIN
+#define COUNTING_ELEMENTS   JSON_INTEGER
+
+// Array scanner flags
+#define SCAN_STRING     1   ///< Inside a string
+#define SCAN_ESCAPE     2   ///< The previous string character was a backslash
+#define SCAN_ELEMENT    4   ///< Inside (or right after) an element. Otherwise the scanner expects the next element.
+
+///< This function scans array elements without tokenizing them.
+static uint8_t scan_array(jspp_t * parser)
+{
+    const char * const end = parser->text + parser->text_length;
+    const char * txt = parser->text + parser->token_start + parser->token_length;
+    if (parser->token == JSON_STRING || parser->token == JSON_MEMBER_NAME) {
+        // move past the closing '"'
+        ++txt;
+    }
+    jspp_search_t * search = parser->search;
+    uint8_t  mode  = parser->skip_token;
+    uint8_t  flags = search->flags;
+    uint16_t depth = search->depth;
+    uint32_t count = search->count;
+
+    for (; txt < end; ++txt) {
+        char c = *txt;
+        if (flags & SCAN_STRING) {
+            if (flags & SCAN_ESCAPE) {
+                flags &= ~SCAN_ESCAPE;
+                continue;
+            }
+            txt = skip_string_chars(txt, end);
+            if (txt == end) {
+                break;
+            }
+            if (*txt == '\\') {
+                flags |= SCAN_ESCAPE;
+            } else {
+                flags &= ~SCAN_STRING;
+            }
+            continue;
+        }
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            continue;
+        }
+        if (depth == 0) {
+            if (c == ']' || c == '}') {
+                // the parser takes over at the end of the array, and a '}' that closes nothing is invalid there
+                break;
+            }
+            if (c == ',') {
+                flags &= ~SCAN_ELEMENT;
+                set_state(parser, EXPECTING_ARRAY_ELEMENT);
+                continue;
+            }
+            if (!(flags & SCAN_ELEMENT)) {
+                if (mode == SEEKING_INDEX && count == 0) {
+                    break;
+                }
+                flags |= SCAN_ELEMENT;
+                set_state(parser, EXPECTING_ARRAY_TAIL);
+                count = mode == SEEKING_INDEX ? count - 1 : count + 1;
+            }
+        }
+        switch (c) {
+            case '"': {
+                flags |= SCAN_STRING;
+                break;
+            }
+            case '[':
+            case '{': {
+                ++depth;
+                break;
+            }
+            case ']':
+            case '}': {
+                --depth;
+                break;
+            }
+        }
+    }
+    search->count = count;
+    parser->token_length = 0;
+    parser->token = JSON_CONTINUE;
+
+    if (txt == end) {
+        search->flags = flags;
+        search->depth = depth;
+        parser->token_start = parser->text_length;
+        return JSON_CONTINUE;
+    }
+    // the parser stack has been kept up to date, so the parser can continue from here
+    parser->skip_token = 0;
+    parser->search = NULL;
+    parser->token_start = txt - parser->text;
+    return jspp_next(parser);
+}
+
+///< This function prepares the array scanner and starts scanning
+static uint8_t start_array_scan(jspp_t * parser, jspp_search_t * search, uint8_t mode, uint32_t count)
+{
+    if (parser->level >= JSON_MAX_STACK) {
+        return JSON_TOO_DEEP;
+    }
+    uint8_t state = get_state(parser);
+    if (state != EXPECTING_ARRAY_ELEMENT_OR_END && state != EXPECTING_ARRAY_ELEMENT && state != EXPECTING_ARRAY_TAIL) {
+        return JSON_INVALID;
+    }
+    search->key = NULL;
+    search->count = count;
+    search->depth = 0;
+    search->flags = state == EXPECTING_ARRAY_TAIL ? SCAN_ELEMENT : 0;
+    parser->skip_token = mode;
+    parser->search = search;
+    return scan_array(parser);
+}
+
+uint8_t jspp_seek_index(jspp_t * parser, jspp_search_t * search, uint32_t count)
+{
+    return start_array_scan(parser, search, SEEKING_INDEX, count);
+}
+
+uint8_t jspp_count_elements(jspp_t * parser, jspp_search_t * search)
+{
+    return start_array_scan(parser, search, COUNTING_ELEMENTS, 0);
+}
+
+uint32_t jspp_element_count(const jspp_search_t * search)
+{
+    return search->count;
+}
+
+#define NUMBER_PART_TOO_LONG (JSPP_NUMBER_PART_SIZE + 1) ///< Reader `length` of the split number that did not fit
+
+///< Returns true if the character can be a part of a number
+static inline int is_number_char(char c)
+{
+    return ('0' <= c && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-';
+}
+
+/**
+ * \brief Finds the end of the number that starts at `txt`.
+ *
+ * \return Pointer to the first character after the number or NULL if the text is not a valid number
+ *         or if the number might continue in the next fragment. The parser then takes over.
+ */
+static const char * number_end(const char * txt, const char * end)
+{
+    if (*txt == '-' && ++txt == end) {
+        return NULL;
+    }
+    if (*txt == '0') {
+        ++txt;
+    } else if ('1' <= *txt && *txt <= '9') {
+        txt = skip_digits(txt + 1, end);
+    } else {
+        return NULL;
+    }
+    if (txt < end && *txt == '.') {
+        const char * digits = txt + 1;
+        txt = skip_digits(digits, end);
+        if (txt == digits) {
+            return NULL;
+        }
+    }
+    if (txt < end && (*txt == 'e' || *txt == 'E')) {
+        if (++txt < end && (*txt == '+' || *txt == '-')) {
+            ++txt;
+        }
+        const char * digits = txt;
+        txt = skip_digits(digits, end);
+        if (txt == digits) {
+            return NULL;
+        }
+    }
+    // the text like `1.2.3` is left for the parser to reject
+    return txt < end && !is_number_char(*txt) ? txt : NULL;
+}
+
+/**
+ * \brief Converts the number into `doubles[index]` or `integers[index]`.
+ *
+ * \param text      The number text
+ * \param length    The length of the number
+ * \param available The length of the text that can be read. The converters read the digits a word at
+ *                  a time when there is enough text after them, and they stop at the end of the number anyway.
+ *
+ * \return 0 if the number cannot be stored
+ */
+static inline int convert_number(const char * text, uint16_t length, uint16_t available, double * doubles, int64_t * integers, uint32_t index)
+{
+    if (doubles) {
+        return jspp_scan_double(text, available, doubles + index) == length;
+    }
+    return jspp_scan_int64(text, available, integers + index) == length;
+}
+
+///< Appends the current number part to the collected parts of the split number
+static void keep_number_part(jspp_t * parser, jspp_number_reader_t * reader)
+{
+    uint16_t length = parser->token_length;
+    if (reader->length + length > JSPP_NUMBER_PART_SIZE) {
+        reader->length = NUMBER_PART_TOO_LONG;
+        return;
+    }
+    const char * text = parser->text + parser->token_start;
+    for (uint16_t i = 0; i < length; i++) {
+        reader->part[reader->length++] = text[i];
+    }
+}
+
+///< Converts the current number token (joined with its first parts if it has been split)
+static int convert_current_number(jspp_t * parser, jspp_number_reader_t * reader, double * doubles, int64_t * integers, uint32_t index)
+{
+    if (reader->length == 0) {
+        uint16_t available = parser->text_length - parser->token_start;
+        return convert_number(parser->text + parser->token_start, parser->token_length, available, doubles, integers, index);
+    }
+    keep_number_part(parser, reader);
+    uint8_t length = reader->length;
+    reader->length = 0;
+    return length <= JSPP_NUMBER_PART_SIZE && convert_number(reader->part, length, length, doubles, integers, index);
+}
+
+///< Reads the array numbers into either `doubles` or `integers`
+static uint32_t read_numbers(jspp_t * parser, jspp_number_reader_t * reader, double * doubles, int64_t * integers, uint32_t capacity)
+{
+    if (parser->level >= JSON_MAX_STACK || parser->search || parser->capture || parser->skip_token) {
+        return 0;
+    }
+    uint32_t count = 0;
+    uint8_t  token = parser->token;
+    if (token == JSON_NUMBER_PART) {
+        uint8_t array_state = parser->stack[parser->level - 1];
+        if (capacity == 0 || (array_state != EXPECTING_ARRAY_ELEMENT_OR_END && array_state != EXPECTING_ARRAY_ELEMENT)) {
+            return 0;
+        }
+        // the rest of the number is in the next fragment
+        keep_number_part(parser, reader);
+        parser->token = jspp_next(parser);
+        return 0;
+    }
+    uint8_t state = get_state(parser);
+    if (state != EXPECTING_ARRAY_ELEMENT_OR_END && state != EXPECTING_ARRAY_ELEMENT && state != EXPECTING_ARRAY_TAIL) {
+        return 0;
+    }
+    if (JSON_INTEGER <= token && token <= JSON_FLOATING_POINT) {
+        if (capacity == 0 || !convert_current_number(parser, reader, doubles, integers, 0)) {
+            return 0;
+        }
+        count = 1;
+    }
+    reader->length = 0;
+
+    const char * const end = parser->text + parser->text_length;
+    const char * txt = parser->text + token_end(parser);
+    while (count < capacity) {
+        txt = skip_whitespace(txt, end);
+        if (txt == end) {
+            break;
+        }
+        if (state == EXPECTING_ARRAY_TAIL) {
+            if (*txt != ',') {
+                break;
+            }
+            state = EXPECTING_ARRAY_ELEMENT;
+            txt = skip_whitespace(txt + 1, end);
+            if (txt == end) {
+                break;
+            }
+        }
+        const char * next = number_end(txt, end);
+        if (!next || !convert_number(txt, next - txt, end - txt, doubles, integers, count)) {
+            break;
+        }
+        ++count;
+        state = EXPECTING_ARRAY_TAIL;
+        txt = next;
+    }
+
+    // the parser continues from the first character that has not been read
+    set_state(parser, state);
+    parser->token_start = txt - parser->text;
+    parser->token_length = 0;
+    parser->token = JSON_CONTINUE;
+    token = jspp_next(parser);
+    if (token == JSON_NUMBER_PART && count < capacity) {
+        keep_number_part(parser, reader);
+        parser->token = jspp_next(parser);
+    }
+    return count;
+}
+
+void jspp_number_reader_init(jspp_number_reader_t * reader)
+{
+    reader->length = 0;
+}
+
+uint32_t jspp_read_number_array(jspp_t * parser, jspp_number_reader_t * reader, double * out, uint32_t capacity)
+{
+    return read_numbers(parser, reader, out, NULL, capacity);
+}
+
+uint32_t jspp_read_int64_array(jspp_t * parser, jspp_number_reader_t * reader, int64_t * out, uint32_t capacity)
+{
+    return read_numbers(parser, reader, NULL, out, capacity);
+}
+
 const char * jspp_text(jspp_t * parser, uint16_t * token_length)
 {
     *token_length = parser->token_length;
@@ -469,7 +1087,9 @@ const char * jspp_text(jspp_t * parser, uint16_t * token_length)
 
 uint8_t jspp_start(jspp_t * parser, const char * text, uint16_t text_len)
 {
+    JSPP_PROBE1(start, text_len);
     parser->text = text;
+    parser->text_offset = 0;
     parser->text_length = text_len;
     parser->token_start = 0;
     parser->token_length = 0;
@@ -478,26 +1098,387 @@ uint8_t jspp_start(jspp_t * parser, const char * text, uint16_t text_len)
     parser->skip_level = 0;
     parser->level = 0;
     parser->stack[parser->level] = EXPECTING_JSON;
+    parser->search = NULL;
+    parser->intern = NULL;
+    parser->capture = NULL;
 
     return jspp_next(parser);
 }
 
 uint8_t jspp_continue(jspp_t * parser, const char * text, uint16_t text_len)
 {
+    parser->text_offset += parser->text_length;
     parser->text = text;
     parser->text_length = text_len;
     parser->token_start = 0;
     parser->token_length = 0;
     parser->token = JSON_INVALID;
 
+    if (parser->capture) {
+        parser->capture->start = 0;
+    }
+    JSPP_PROBE3(continue__entry, text_len, parser->text_offset, parser->level);
+
+    uint8_t token;
     switch (parser->skip_token) {
         case JSON_CONTINUE: {
-            return jspp_skip_next(parser);
+            // the skipping continues, so it is not a new skip
+            token = capture_fragment(parser, skip(parser, jspp_next(parser)));
+            break;
         }
         case JSON_ARRAY_END:
         case JSON_OBJECT_END: {
-            return skip_composite(parser);
+            token = capture_fragment(parser, skip_composite(parser));
+            break;
+        }
+        case SEEKING_INDEX:
+        case COUNTING_ELEMENTS: {
+            token = scan_array(parser);
+            break;
+        }
+        default: {
+            token = jspp_next(parser);
+        }
+    }
+    if (parser->search && parser->search->key) {
+        token = find_member(parser, token);
+    }
+    JSPP_PROBE2(continue__return, token, parser->level);
+    return token;
+}
+
+#define CHECKPOINT_VERSION 2
+
+static uint8_t * put_uint(uint8_t * ptr, uint64_t val, uint8_t size)
+{
+    for (uint8_t i = 0; i < size; i++) {
+        *ptr++ = (uint8_t) (val >> (i * 8));
+    }
+    return ptr;
+}
+
+static const uint8_t * get_uint(const uint8_t * ptr, uint64_t * val, uint8_t size)
+{
+    uint64_t v = 0;
+    for (uint8_t i = 0; i < size; i++) {
+        v |= (uint64_t) *ptr++ << (i * 8);
+    }
+    *val = v;
+    return ptr;
+}
+
+uint16_t jspp_checkpoint(jspp_t * parser, uint8_t * buffer, uint16_t size)
+{
+    if (parser->search || parser->capture || parser->level >= JSON_MAX_STACK) {
+        return 0;
+    }
+    uint16_t checkpoint_size = JSPP_CHECKPOINT_SIZE - JSON_MAX_STACK + parser->level + 1;
+    if (size < checkpoint_size) {
+        return 0;
+    }
+    uint64_t offset = parser->text_offset + token_end(parser);
+
+    uint8_t * ptr = buffer;
+    *ptr++ = CHECKPOINT_VERSION;
+    ptr = put_uint(ptr, offset, 8);
+    *ptr++ = parser->level;
+    *ptr++ = parser->skip_token;
+    *ptr++ = parser->skip_token ? parser->skip_level : 0;
+    for (uint8_t i = 0; i <= parser->level; i++) {
+        *ptr++ = parser->stack[i];
+    }
+    return ptr - buffer;
+}
+
+/**
+ * \brief Checks whether the parser could have saved the stack.
+ *
+ * \param stack The saved stack
+ * \param level The saved stack level
+ *
+ * \return "true" when every level holds a state the parser can continue from
+ *
+ * The bottom level holds the state of the whole JSON. The levels above it hold the states that expect
+ * the nested element, and the current one - either the scanner state of a partial token or the parser
+ * state of an array or an object. Any other state could make the parser close an element that is not
+ * there and fall out of the stack.
+ */
+static int is_valid_stack(const uint8_t * stack, uint8_t level)
+{
+    if (level == 0) {
+        return stack[0] == EXPECTING_JSON || stack[0] == JSON_END || stack[0] == JSON_INVALID;
+    }
+    if (stack[0] != EXPECTING_JSON) {
+        return 0;
+    }
+    for (uint8_t i = 1; i < level; i++) {
+        if (stack[i] <= EXPECTING_JSON) {
+            return 0;
+        }
+    }
+    uint8_t state = stack[level];
+    return state == JSON_INVALID || (state >= __SCANNER_STATES && state != EXPECTING_JSON);
+}
+
+uint8_t jspp_restore(jspp_t * parser, const uint8_t * checkpoint, uint16_t size, uint64_t * offset)
+{
+    const uint16_t header_size = JSPP_CHECKPOINT_SIZE - JSON_MAX_STACK;
+    if (size < header_size + 1 || checkpoint[0] != CHECKPOINT_VERSION) {
+        return JSON_INVALID;
+    }
+    uint8_t level = checkpoint[9];
+    if (level >= JSON_MAX_STACK || size < header_size + level + 1) {
+        return JSON_INVALID;
+    }
+    uint8_t skip_token = checkpoint[10];
+    uint8_t skip_level = checkpoint[11];
+    if ((skip_token != 0 && skip_token != JSON_CONTINUE && skip_token != JSON_ARRAY_END && skip_token != JSON_OBJECT_END)
+        || skip_level > level || !is_valid_stack(checkpoint + header_size, level)) {
+        return JSON_INVALID;
+    }
+
+    uint64_t val;
+    const uint8_t * ptr = get_uint(checkpoint + 1, &val, 8);
+    *offset = val;
+    parser->text = "";
+    parser->text_offset = val;
+    parser->text_length = 0;
+    parser->token_start = 0;
+    parser->token_length = 0;
+    parser->token = JSON_CONTINUE;
+    parser->level = *ptr++;
+    parser->skip_token = *ptr++;
+    parser->skip_level = *ptr++;
+    for (uint8_t i = 0; i <= level; i++) {
+        parser->stack[i] = *ptr++;
+    }
+    parser->search = NULL;
+    parser->intern = NULL;
+    parser->capture = NULL;
+    return JSON_CONTINUE;
+}
+
+void jspp_intern_init(jspp_intern_t * table, jspp_intern_entry_t * entries, uint16_t capacity, char * names, uint16_t names_size)
+{
+    table->entries = entries;
+    table->names = names;
+    table->capacity = capacity;
+    table->names_size = names_size;
+    table->names_length = 0;
+    table->count = 0;
+    table->member_id = JSPP_MEMBER_UNKNOWN;
+    table->shape = NULL;
+    table->partial_length = 0;
+    for (uint16_t i = 0; i < capacity; i++) {
+        entries[i].length = JSPP_MEMBER_UNKNOWN;
+    }
+}
+
+void jspp_set_intern(jspp_t * parser, jspp_intern_t * table)
+{
+    parser->intern = table;
+    if (table) {
+        table->member_id = JSPP_MEMBER_UNKNOWN;
+        table->shape = NULL;
+        table->partial_length = 0;
+    }
+}
+
+///< FNV-1a
+static uint32_t hash_name(const char * name, uint16_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (uint16_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t) name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+///< Finds the name in the table and adds it there if it is not interned yet
+static uint16_t intern(jspp_intern_t * table, const char * name, uint16_t length)
+{
+    uint32_t hash = hash_name(name, length);
+    uint16_t mask = table->capacity - 1;
+    uint16_t id = hash & mask;
+    for (;;) {
+        jspp_intern_entry_t * entry = &table->entries[id];
+        if (entry->length == JSPP_MEMBER_UNKNOWN) {
+            // The name is not in the table. Note that at least one entry is always left empty to
+            // terminate lookups.
+            if (table->count == mask || length > table->names_size - table->names_length) {
+                return JSPP_MEMBER_UNKNOWN;
+            }
+            char * dst = table->names + table->names_length;
+            for (uint16_t i = 0; i < length; i++) {
+                dst[i] = name[i];
+            }
+            entry->hash = hash;
+            entry->offset = table->names_length;
+            entry->length = length;
+            table->names_length += length;
+            ++table->count;
+            return id;
+        }
+        if (entry->hash == hash && entry->length == length) {
+            const char * str = table->names + entry->offset;
+            uint16_t i = 0;
+            while (i < length && str[i] == name[i]) {
+                ++i;
+            }
+            if (i == length) {
+                return id;
+            }
+        }
+        id = (id + 1) & mask;
+    }
+}
+
+static void intern_member_name(jspp_t * parser, uint8_t token)
+{
+    jspp_intern_t * table = parser->intern;
+    const char * name = parser->text + parser->token_start;
+    uint16_t length = parser->token_length;
+
+    if (token == JSON_MEMBER_NAME && table->partial_length == 0) {
+        table->member_id = intern(table, name, length);
+        return;
+    }
+    // the name is split between fragments - collect it
+    table->member_id = JSPP_MEMBER_UNKNOWN;
+    if (table->partial_length <= JSPP_INTERN_NAME_SIZE) {
+        if (length > JSPP_INTERN_NAME_SIZE - table->partial_length) {
+            // too long to be interned
+            table->partial_length = JSPP_INTERN_NAME_SIZE + 1;
+        } else {
+            char * dst = table->partial + table->partial_length;
+            for (uint16_t i = 0; i < length; i++) {
+                dst[i] = name[i];
+            }
+            table->partial_length += length;
+        }
+    }
+    if (token == JSON_MEMBER_NAME) {
+        if (table->partial_length <= JSPP_INTERN_NAME_SIZE) {
+            table->member_id = intern(table, table->partial, table->partial_length);
+        }
+        table->partial_length = 0;
+    }
+}
+
+uint16_t jspp_member_id(jspp_t * parser)
+{
+    return parser->intern && parser->token == JSON_MEMBER_NAME ? parser->intern->member_id : JSPP_MEMBER_UNKNOWN;
+}
+
+const char * jspp_intern_name(const jspp_intern_t * table, uint16_t id, uint16_t * length)
+{
+    if (id >= table->capacity || table->entries[id].length == JSPP_MEMBER_UNKNOWN) {
+        *length = 0;
+        return NULL;
+    }
+    *length = table->entries[id].length;
+    return table->names + table->entries[id].offset;
+}
+
+void jspp_shape_init(jspp_shape_t * shape, uint8_t depth)
+{
+    shape->level = depth;
+    shape->count = 0;
+    shape->position = 0;
+    shape->predicted = 0;
+    shape->hits = 0;
+    shape->misses = 0;
+}
+
+void jspp_set_shape(jspp_t * parser, jspp_shape_t * shape)
+{
+    if (!parser->intern) {
+        return;
+    }
+    parser->intern->shape = shape;
+    if (shape) {
+        shape->predicted = 0;
+    }
+}
+
+/**
+ * \brief Matches the member name that the shape predicts against the input.
+ *
+ * \param parser A pointer to the parser struct
+ * \param txt    Pointer to the opening quote of the string
+ * \param end    The end of the fragment
+ *
+ * \return Pointer to the last character before the closing quote if the predicted name matches or NULL otherwise.
+ */
+static const char * predict_member_name(jspp_t * parser, const char * txt, const char * end)
+{
+    jspp_shape_t * shape = parser->intern->shape;
+    if (parser->level - 1 != shape->level || shape->position >= shape->count
+        || !is_string_a_member_name(parser->stack[parser->level - 1])) {
+        return NULL;
+    }
+    uint16_t length;
+    const char * name = jspp_intern_name(parser->intern, shape->ids[shape->position], &length);
+    if (!name || end - txt < length + 2) {
+        // the entire name and the closing quote must be in the fragment
+        return NULL;
+    }
+    ++txt;
+    uint16_t i = 0;
+    for (; i + SWAR_SIZE <= length; i += SWAR_SIZE) {
+        if (swar_load(txt + i) != swar_load(name + i)) {
+            return NULL;
+        }
+    }
+    for (; i < length; i++) {
+        if (txt[i] != name[i]) {
+            return NULL;
+        }
+    }
+    if (txt[length] != '"') {
+        return NULL;
+    }
+    shape->predicted = 1;
+    return txt + length - 1;
+}
+
+///< Records member names of the objects at the shape level
+static void track_shape(jspp_t * parser, uint8_t token)
+{
+    jspp_shape_t * shape = parser->intern->shape;
+    uint8_t predicted = shape->predicted;
+    shape->predicted = 0;
+    if (!predicted && (token == JSON_MEMBER_NAME || token == JSON_MEMBER_NAME_PART)) {
+        intern_member_name(parser, token);
+    }
+    switch (token) {
+        case JSON_OBJECT_BEGIN: {
+            if (parser->level == shape->level) {
+                shape->position = 0;
+            }
+            break;
+        }
+        case JSON_MEMBER_NAME: {
+            if (parser->level != shape->level || shape->position == JSPP_SHAPE_MAX_MEMBERS) {
+                break;
+            }
+            if (predicted) {
+                ++shape->hits;
+                parser->intern->member_id = shape->ids[shape->position];
+            } else {
+                // The new name replaces the predicted one. This does not affect the predictions
+                // for the rest of this object as they are at the following positions.
+                ++shape->misses;
+                shape->ids[shape->position] = parser->intern->member_id;
+            }
+            ++shape->position;
+            break;
+        }
+        case JSON_OBJECT_END: {
+            if (parser->level + 1 == shape->level) {
+                shape->count = shape->position;
+            }
+            break;
         }
     }
-    return jspp_next(parser);
 }
@@ -3,6 +3,16 @@
 
 #define JSON_MAX_STACK 14
 
+#define JSPP_CHECKPOINT_SIZE (12 + JSON_MAX_STACK) ///< Maximum size of the serialized parser state
+
+#define JSPP_INTERN_NAME_SIZE 64 ///< Maximum length of a member name that is split between fragments and can be interned
+
+#define JSPP_SHAPE_MAX_MEMBERS 32 ///< Maximum number of members of the object which shape is predicted
+
+#define JSPP_MEMBER_UNKNOWN 0xffff ///< Member ID of a name that is not in the intern table
+
+#define JSPP_NUMBER_PART_SIZE 32 ///< Maximum length of a number that is split between fragments and can be read into an array
+
 #include <stdint.h>
 
 enum _json_tokens {
@@ -37,8 +47,74 @@ enum _json_tokens {
     JSON_ARRAY_END
 };
 
+/**
+ * \brief Receives the raw text of the captured element.
+ *
+ * \param data      Pointer to the element text in the current fragment
+ * \param size      The size of the text
+ * \param sink_data The pointer that was passed to `jspp_capture_init`
+ */
+typedef void (*jspp_sink_t)(const char * data, uint16_t size, void * sink_data);
+
+/// Progress of `jspp_capture_next`
+typedef struct _jspp_capture {
+    jspp_sink_t sink;       ///< Receives the text of the element that is being captured
+    void *      sink_data;
+    uint16_t    start;      ///< Index of the first character of the captured text in the current fragment
+    uint8_t     begun;      ///< Set when some of the element text has been passed to the sink
+} jspp_capture_t;
+
+/// Member names of the last object at the tracked level
+typedef struct _jspp_shape {
+    uint16_t    ids[JSPP_SHAPE_MAX_MEMBERS]; ///< Interned member name IDs in the order they appeared
+    uint8_t     level;      ///< Parser level of the tracked objects
+    uint8_t     count;      ///< Number of members of the previous object
+    uint8_t     position;   ///< Index of the next member of the current object
+    uint8_t     predicted;  ///< Set when the member name that is being returned has been predicted
+    uint32_t    hits;       ///< Number of member names that were predicted correctly
+    uint32_t    misses;     ///< Number of member names that were not predicted
+} jspp_shape_t;
+
+/// An interned member name
+typedef struct _jspp_intern_entry {
+    uint32_t    hash;
+    uint16_t    offset;     ///< Offset of the name in the names buffer
+    uint16_t    length;     ///< Name length or `JSPP_MEMBER_UNKNOWN` if the entry is empty
+} jspp_intern_entry_t;
+
+/// Member name intern table
+typedef struct _jspp_intern {
+    jspp_intern_entry_t * entries;      ///< Caller supplied hash table
+    char *                names;        ///< Caller supplied buffer for the name text
+    jspp_shape_t *        shape;        ///< Member order predictor attached by `jspp_set_shape`
+    uint16_t              capacity;     ///< Number of entries. It must be a power of 2.
+    uint16_t              names_size;
+    uint16_t              names_length; ///< Number of bytes used in the names buffer
+    uint16_t              count;        ///< Number of interned names
+    uint16_t              member_id;    ///< Interned ID of the current member name of the parser the table is attached to
+    uint16_t              partial_length; ///< Length of the collected split name
+    char                  partial[JSPP_INTERN_NAME_SIZE]; ///< The first parts of the name that is split between fragments
+} jspp_intern_t;
+
+/// Progress of the member search or the array scan
+typedef struct _jspp_search {
+    const char * key;       ///< Member name `jspp_find_member` is looking for. NULL while an array is scanned.
+    uint16_t     key_length;
+    uint16_t     matched;   ///< Length of the member name part that has matched the key so far
+    uint32_t     count;     ///< Array elements `jspp_seek_index` still has to skip or `jspp_count_elements` has counted
+    uint16_t     depth;     ///< Nesting level inside the array element that is being scanned
+    uint8_t      flags;     ///< Array scanner state
+} jspp_search_t;
+
+/// The first parts of the number that is split between fragments while an array is read
+typedef struct _jspp_number_reader {
+    uint8_t     length;     ///< Length of the collected parts
+    char        part[JSPP_NUMBER_PART_SIZE];
+} jspp_number_reader_t;
+
 typedef struct _json_parser {
     const char *  text;         ///< JSON text fragment
+    uint64_t      text_offset;  ///< Offset of the text fragment from the beginning of JSON
     uint16_t      text_length;  ///< Size of the text fragment
     uint16_t      token_start;  ///< Index of the first character of the token text
     uint16_t      token_length; ///< Token text length. Note that quotes are not a part of the string/member name token text.
@@ -47,6 +123,9 @@ typedef struct _json_parser {
     uint8_t       skip_level;   ///< Skip termination level
     uint8_t       level;        ///< Current stack level
     uint8_t       stack[JSON_MAX_STACK];
+    jspp_intern_t * intern;     ///< Member name intern table
+    jspp_capture_t * capture;   ///< The capture in progress
+    jspp_search_t *  search;    ///< The member search or the array scan in progress
 } jspp_t;
 
 /**
@@ -123,6 +202,39 @@ const char * jspp_text(jspp_t * parser, uint16_t * length);
  */
 uint8_t jspp_skip_next(jspp_t * parser);
 
+/**
+ * \brief Prepares the capture of an element.
+ *
+ * \param capture   A pointer to the capture struct allocated by the caller
+ * \param sink      The function that receives the element text
+ * \param sink_data The pointer that is passed to the sink
+ *
+ * The capture struct keeps the sink and the progress of `jspp_capture_next`, so the parser does not
+ * need space for them. It can be reused for the next captures.
+ */
+void jspp_capture_init(jspp_capture_t * capture, jspp_sink_t sink, void * sink_data);
+
+/**
+ * \brief Skips the next JSON element, passes its raw text to the sink and returns the token that follows the element.
+ *
+ * \param parser  A pointer to the parser struct
+ * \param capture A pointer to the capture struct prepared by `jspp_capture_init`
+ *
+ * \return The ID of the token after the captured element
+ *
+ * This function works like `jspp_skip_next`, but it also passes the text of the skipped element - from
+ * its first to its last character, as it appears in JSON - to the sink. When the element is in the
+ * current fragment the sink is called once with the part of the fragment the element occupies, so
+ * the element can be forwarded or stored without copying or re-serialization. When the element
+ * crosses fragments the sink is called with its part in each fragment, the last one once `jspp_continue`
+ * reaches the end of the element.
+ *
+ * If the next token is a member name, the member value is captured. The function should be called
+ * between elements - not while a number or a string is returned in parts. The capture struct must stay
+ * available until the element is captured.
+ */
+uint8_t jspp_capture_next(jspp_t * parser, jspp_capture_t * capture);
+
 /**
  * \brief Skips the current JSON element and returns the token that follows the skipped element.
  *
@@ -137,4 +249,255 @@ uint8_t jspp_skip_next(jspp_t * parser);
  */
 uint8_t jspp_skip(jspp_t * parser);
 
+/**
+ * \brief Finds the object member with the specified name and returns the first token of its value.
+ *
+ * \param parser     A pointer to the parser struct
+ * \param search     A pointer to the search struct allocated by the caller
+ * \param key        The name of the member
+ * \param key_length The length of the name
+ *
+ * \return The ID of the first token of the member value or `JSON_OBJECT_END` if the rest of the
+ *         object does not have the member.
+ *
+ * This function scans the remaining members of the current object. Values of the members with
+ * different names are skipped. If the current token is a member name it is checked first.
+ *
+ * Like `jspp_skip_next` this function might reach the end of the current text fragment and return
+ * `JSON_CONTINUE`. The search then continues when `jspp_continue` is called and `jspp_continue`
+ * returns the first token of the member value (or `JSON_OBJECT_END`). Thus the search struct and
+ * the key must remain valid until the search is complete.
+ *
+ * Note that the key is compared to the member name as it appears in JSON. In other words the key
+ * should have the same escapes as the member name in JSON.
+ */
+uint8_t jspp_find_member(jspp_t * parser, jspp_search_t * search, const char * key, uint16_t key_length);
+
+/**
+ * \brief Skips the specified number of array elements and returns the first token of the element after them.
+ *
+ * \param parser A pointer to the parser struct
+ * \param search A pointer to the search struct allocated by the caller
+ * \param count  The number of elements to skip
+ *
+ * \return The ID of the first token of the element after the skipped ones, `JSON_ARRAY_END` if the array
+ *         has fewer elements, or `JSON_INVALID` if the parser is not positioned inside an array.
+ *
+ * The parser must be positioned inside an array - after `JSON_ARRAY_BEGIN` or after one of the array
+ * elements. Thus, right after `JSON_ARRAY_BEGIN` `jspp_seek_index(parser, n)` returns the element at
+ * index `n`.
+ *
+ * Unlike `jspp_skip_next` this function does not recognize tokens of the skipped elements. It only looks
+ * for commas that separate the array elements, brackets and braces that nest, and quotes and escapes of
+ * strings that might contain those. Thus it is much faster than skipping elements one by one. However
+ * the skipped elements are not validated.
+ *
+ * Like `jspp_skip_next` this function might return `JSON_CONTINUE`. `jspp_continue` then continues
+ * skipping and returns the first token of the element after the skipped ones. The search struct
+ * keeps the scan progress, so it must remain valid until then.
+ */
+uint8_t jspp_seek_index(jspp_t * parser, jspp_search_t * search, uint32_t count);
+
+/**
+ * \brief Counts the remaining elements of the array.
+ *
+ * \param parser A pointer to the parser struct
+ * \param search A pointer to the search struct allocated by the caller
+ *
+ * \return `JSON_ARRAY_END` when the end of the array is reached or `JSON_INVALID` if the parser is not
+ *         positioned inside an array.
+ *
+ * The elements are scanned, but not tokenized, like they are by `jspp_seek_index`. This function might
+ * return `JSON_CONTINUE`. `jspp_continue` then continues counting and returns `JSON_ARRAY_END` when all
+ * the remaining elements are counted. The number of counted elements is returned by `jspp_element_count`.
+ */
+uint8_t jspp_count_elements(jspp_t * parser, jspp_search_t * search);
+
+/**
+ * \brief Returns the number of array elements counted by `jspp_count_elements`.
+ *
+ * \param search A pointer to the search struct that has been passed to `jspp_count_elements`
+ *
+ * \return Number of elements
+ */
+uint32_t jspp_element_count(const jspp_search_t * search);
+
+/**
+ * \brief Prepares the number reader.
+ *
+ * \param reader A pointer to the reader struct allocated by the caller
+ *
+ * The reader keeps the first parts of a number that is split between fragments, so the parser
+ * itself does not need space for them. It is passed to every `jspp_read_number_array` or
+ * `jspp_read_int64_array` call that reads the array.
+ */
+void jspp_number_reader_init(jspp_number_reader_t * reader);
+
+/**
+ * \brief Reads the numbers of the array into the caller's array of doubles.
+ *
+ * \param      parser   A pointer to the parser struct
+ * \param      reader   A pointer to the number reader
+ * \param[out] out      The array that receives the numbers
+ * \param      capacity The number of elements in the `out` array
+ *
+ * \return The number of numbers that have been stored in `out`
+ *
+ * The parser must be positioned at `JSON_ARRAY_BEGIN` or at a number element of an array. The current
+ * number and the numbers that follow it are converted without returning their tokens. Reading stops
+ * when `out` is full, at the element that is not a number, at the end of the array, or at the end of
+ * the fragment. After that `parser->token` is the first token that has not been read:
+ * - `JSON_CONTINUE` - call `jspp_continue` with the next fragment and then call this function again.
+ *   A number that is split between fragments is kept in the reader and is read by that call.
+ * - `JSON_ARRAY_END`
+ * - the first token of the element that is not a number
+ * - a number (or `JSON_NUMBER_PART`) if `out` is full or the number cannot be converted
+ *
+ * Numbers that are split between fragments and are longer than `JSPP_NUMBER_PART_SIZE` cannot be
+ * read. Like with split literals only the last part of such number is available then. Note also that
+ * `jspp_checkpoint` does not save the parts the reader holds.
+ */
+uint32_t jspp_read_number_array(jspp_t * parser, jspp_number_reader_t * reader, double * out, uint32_t capacity);
+
+/**
+ * \brief Reads the integers of the array into the caller's array of 64-bit integers.
+ *
+ * \param      parser   A pointer to the parser struct
+ * \param      reader   A pointer to the number reader
+ * \param[out] out      The array that receives the integers
+ * \param      capacity The number of elements in the `out` array
+ *
+ * \return The number of integers that have been stored in `out`
+ *
+ * This function works like `jspp_read_number_array`, but it also stops at the number that is not
+ * an integer or does not fit into 64 bits.
+ */
+uint32_t jspp_read_int64_array(jspp_t * parser, jspp_number_reader_t * reader, int64_t * out, uint32_t capacity);
+
+/**
+ * \brief Saves the parser state.
+ *
+ * \param      parser A pointer to the parser struct
+ * \param[out] buffer The buffer that will receive the parser state
+ * \param      size   The size of the buffer. `JSPP_CHECKPOINT_SIZE` bytes is always enough.
+ *
+ * \return The number of bytes saved in the buffer or 0 if the buffer is too small or the state
+ *         cannot be saved.
+ *
+ * The saved state includes the offset - from the beginning of JSON - of the first character that
+ * the parser has not processed yet. The state is saved in a platform independent format. Thus it
+ * can be stored and later restored by `jspp_restore`, maybe even on another machine, to continue
+ * parsing from that point.
+ *
+ * Note that the state cannot be saved while `jspp_find_member` is looking for a member or
+ * `jspp_seek_index` and `jspp_count_elements` are scanning an array, as their progress is kept
+ * in the caller's search struct, or while `jspp_capture_next` is capturing an element. Note
+ * also that when the current token is a partial one, the restored parser will continue scanning
+ * that token, but the text of the token that has been returned before the checkpoint will not be
+ * available.
+ */
+uint16_t jspp_checkpoint(jspp_t * parser, uint8_t * buffer, uint16_t size);
+
+/**
+ * \brief Restores the parser state saved by `jspp_checkpoint`.
+ *
+ * \param      parser     A pointer to the parser struct
+ * \param      checkpoint The saved parser state
+ * \param      size       The size of the saved state
+ * \param[out] offset     A pointer to the variable that will receive the offset - from the beginning
+ *                        of JSON - of the text that the parser expects next
+ *
+ * \return `JSON_CONTINUE` if the state has been restored or `JSON_INVALID` if the checkpoint is damaged.
+ *
+ * The restored parser expects the next fragment to start at the returned offset. It should be passed
+ * to the parser via `jspp_continue`.
+ *
+ * The checkpoint is rejected unless every saved state is one the parser could have saved at its level
+ * and the skip progress is consistent with the stack. Thus a damaged checkpoint cannot make the parser
+ * leave its stack, though it might still resume at the wrong place.
+ */
+uint8_t jspp_restore(jspp_t * parser, const uint8_t * checkpoint, uint16_t size, uint64_t * offset);
+
+/**
+ * \brief Initializes the member name intern table.
+ *
+ * \param table      A pointer to the table struct allocated by the caller
+ * \param entries    An array of entries that will hold the table
+ * \param capacity   Number of entries in the array. It must be a power of 2.
+ * \param names      The buffer that will hold the text of the interned names
+ * \param names_size The size of the names buffer
+ *
+ * The table maps member names to small integer IDs - from 0 to `capacity - 1` - that are learned at
+ * runtime as the names are encountered. A name keeps its ID for the lifetime of the table, so it can
+ * be shared by all documents of a stream. Once the table is full or there is no more space for names
+ * new names are not interned anymore.
+ *
+ * The table also holds the ID of the current member name and the parts of a name that is split between
+ * fragments, so it is attached to one parser at a time.
+ */
+void jspp_intern_init(jspp_intern_t * table, jspp_intern_entry_t * entries, uint16_t capacity, char * names, uint16_t names_size);
+
+/**
+ * \brief Attaches the intern table to the parser.
+ *
+ * \param parser A pointer to the parser struct
+ * \param table  A pointer to the intern table or NULL to detach the table
+ *
+ * This function must be called after `jspp_start` (or `jspp_restore`) as those detach the table.
+ * When the table is attached the parser interns every member name it returns. The ID of the current
+ * member name is returned by `jspp_member_id`.
+ */
+void jspp_set_intern(jspp_t * parser, jspp_intern_t * table);
+
+/**
+ * \brief Returns the ID of the current member name.
+ *
+ * \param parser A pointer to the parser struct
+ *
+ * \return The ID of the member name or `JSPP_MEMBER_UNKNOWN` if the current token is not `JSON_MEMBER_NAME`
+ *         or the name could not be interned.
+ *
+ * Names that are split between fragments are interned too (when they are not longer than
+ * `JSPP_INTERN_NAME_SIZE`). In this case the ID is returned with the final `JSON_MEMBER_NAME` part.
+ */
+uint16_t jspp_member_id(jspp_t * parser);
+
+/**
+ * \brief Returns the text of the interned name.
+ *
+ * \param      table  A pointer to the intern table
+ * \param      id     The member name ID
+ * \param[out] length A pointer to the variable in which the length of the name will be returned
+ *
+ * \return Pointer to the name text or NULL if there is no name with this ID.
+ */
+const char * jspp_intern_name(const jspp_intern_t * table, uint16_t id, uint16_t * length);
+
+/**
+ * \brief Initializes the member order predictor.
+ *
+ * \param shape A pointer to the shape struct allocated by the caller
+ * \param depth The nesting depth of the objects which member order will be predicted. Top level objects
+ *              are at depth 1, objects in the top level array are at depth 2, and so on.
+ */
+void jspp_shape_init(jspp_shape_t * shape, uint8_t depth);
+
+/**
+ * \brief Attaches the member order predictor to the parser.
+ *
+ * \param parser A pointer to the parser struct
+ * \param shape  A pointer to the shape struct or NULL to detach it
+ *
+ * The shape remembers the member names of the last object at its depth and expects the next object
+ * to have the same members in the same order. The predicted name is compared to the input as a whole.
+ * When it matches, the name is not scanned character by character and its ID is known without a
+ * lookup in the intern table. Otherwise the name is scanned and interned as usual. `hits` and `misses`
+ * of the shape show how often the prediction was right.
+ *
+ * The predictor needs the intern table - it is kept in the table, so it must be attached after the table
+ * (attaching the table detaches the shape) and it is ignored when no table is attached. Like the table the
+ * shape must be attached after `jspp_start` and it can be kept for the next documents.
+ */
+void jspp_set_shape(jspp_t * parser, jspp_shape_t * shape);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,340 @@
+#ifndef __JSPP_HPP
+#define __JSPP_HPP
+
+// Header-only C++20 layer over the jspp C API. Everything here is inline and calls the C functions
+// directly, so a loop over `jspp::parser` compiles to the same code as the loop over `jspp_t`.
+
+extern "C" {
+#include "jspp.h"
+}
+#include <coroutine>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace jspp {
+
+using token_t = uint8_t;
+
+/// Checks whether the token is a part of a name, a number or a string that continues in the next fragment
+constexpr bool is_part(token_t token)
+{
+    return token == JSON_MEMBER_NAME_PART || token == JSON_NUMBER_PART || token == JSON_STRING_PART;
+}
+
+/// Checks whether the token is an element (or its part) rather than the end of JSON, the end of the fragment or an error
+constexpr bool is_element(token_t token)
+{
+    return token > JSON_CONTINUE;
+}
+
+/// A string literal that can be passed as a template argument
+template <std::size_t N>
+struct key {
+    char text[N];
+
+    constexpr key(const char (&str)[N])
+    {
+        for (std::size_t i = 0; i < N; i++) {
+            text[i] = str[i];
+        }
+    }
+
+    static constexpr std::size_t size() { return N - 1; }
+
+    constexpr std::string_view view() const { return std::string_view(text, N - 1); }
+};
+
+/**
+ * \brief Checks whether the name is the key.
+ *
+ * The key is known at compile time, so the length is compared with a constant and the comparison of
+ * the text is unrolled by the compiler.
+ */
+template <key K>
+constexpr bool is(std::string_view name)
+{
+    return name.size() == K.size() && name == K.view();
+}
+
+/**
+ * \brief Finds the name among the keys.
+ *
+ * \return The index of the key that matches the name or -1
+ *
+ * Use it in a `switch` over the member names of an object:
+ * \code
+ * switch (jspp::match<"sunrise", "sunset", "day_length">(name)) {
+ *     case 0: ...
+ * \endcode
+ */
+template <key... Keys>
+constexpr int match(std::string_view name)
+{
+    int index = -1;
+    int i = 0;
+    // stops at the first match
+    ((is<Keys>(name) ? (index = i, true) : (++i, false)) || ...);
+    return index;
+}
+
+/// The parser of a JSON text that is in memory or that is passed to it fragment by fragment
+class parser {
+public:
+    parser() = default;
+
+    explicit parser(std::string_view text) { start(text); }
+
+    // The state refers to the current fragment and to the search `find_member` continues
+    parser(const parser &) = delete;
+    parser & operator=(const parser &) = delete;
+
+    token_t start(std::string_view text) { return jspp_start(&state, text.data(), (uint16_t) text.size()); }
+    token_t resume(std::string_view text) { return jspp_continue(&state, text.data(), (uint16_t) text.size()); }
+    token_t next() { return jspp_next(&state); }
+    token_t skip() { return jspp_skip(&state); }
+    token_t skip_next() { return jspp_skip_next(&state); }
+    token_t find_member(std::string_view key) { return jspp_find_member(&state, &search, key.data(), (uint16_t) key.size()); }
+    token_t token() const { return state.token; }
+
+    /// Text of the current token. It is valid until the next fragment is passed to the parser.
+    std::string_view text()
+    {
+        uint16_t length;
+        const char * data = jspp_text(&state, &length);
+        return std::string_view(data, length);
+    }
+
+    jspp_t * get() { return &state; }
+
+private:
+    jspp_t state;
+    jspp_search_t search;
+};
+
+class stream;
+
+/**
+ * \brief The coroutine that extracts data from a JSON stream.
+ *
+ * The coroutine starts right away and runs until it needs the first fragment. It is destroyed with
+ * the task object. Exceptions that escape the coroutine are thrown from `stream::push` (or from the
+ * coroutine call itself if they are thrown before the first suspension).
+ */
+class task {
+public:
+    struct promise_type {
+        task get_return_object() { return task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { throw; }
+    };
+
+    task(task && other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    task(const task &) = delete;
+    task & operator=(const task &) = delete;
+    ~task()
+    {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    /// Checks whether the coroutine has returned
+    bool done() const { return !handle || handle.done(); }
+
+private:
+    explicit task(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * \brief The parser that suspends the coroutine when it reaches the end of the fragment.
+ *
+ * The coroutine awaits tokens - `co_await stream.next()` - as if the entire JSON were in memory. When
+ * the parser needs the next fragment the coroutine is suspended and `push` resumes it once the
+ * awaited token has been found in the pushed fragment(s):
+ * \code
+ * jspp::task extract(jspp::stream & json, times_t & times)
+ * {
+ *     if (co_await json.next() != JSON_OBJECT_BEGIN) co_return;
+ *     std::string name;
+ *     while (co_await json.read(name) == JSON_MEMBER_NAME) {
+ *         switch (jspp::match<"sunrise", "sunset">(name)) {
+ *             case 0:  co_await json.read(times.sunrise); break;
+ *             case 1:  co_await json.read(times.sunset); break;
+ *             default: co_await json.skip(); break;
+ *         }
+ *     }
+ * }
+ * \endcode
+ * The stream must outlive the coroutine that uses it.
+ */
+class stream {
+public:
+    // The parser starts with an empty fragment, so the coroutine can await tokens before the first push
+    stream() { jspp_start(&state, "", 0); }
+    stream(const stream &) = delete;
+    stream & operator=(const stream &) = delete;
+
+    /**
+     * \brief Awaits the token that the operation finds.
+     *
+     * `fresh` starts at the current token and `held` at the token that `skip` has found and kept for
+     * the next operation.
+     */
+    template <token_t (*fresh)(jspp_t *), token_t (*held)(jspp_t *), bool hold>
+    struct step {
+        stream & json;
+
+        bool await_ready()
+        {
+            token_t result = json.holding ? held(&json.state) : fresh(&json.state);
+            json.holding = false;
+            return json.begin(result);
+        }
+        void await_suspend(std::coroutine_handle<> h) { json.waiting = h; }
+        token_t await_resume() const
+        {
+            json.holding = hold;
+            return json.token;
+        }
+    };
+
+    /// Awaits the member with the name
+    struct member {
+        stream & json;
+        std::string_view key;
+
+        bool await_ready()
+        {
+            // the search starts at the name `skip` might have found
+            json.holding = false;
+            return json.begin(jspp_find_member(&json.state, &json.search, key.data(), (uint16_t) key.size()));
+        }
+        void await_suspend(std::coroutine_handle<> h) { json.waiting = h; }
+        token_t await_resume() const { return json.token; }
+    };
+
+    /// The "operation" that returns the token the parser is at
+    static token_t current(jspp_t * state) { return state->token; }
+
+    using next_step = step<jspp_next, current, false>;
+    using skip_step = step<jspp_skip_next, jspp_skip, true>;
+
+    /// Awaits the next token. Names, numbers and strings that cross fragments are returned in parts.
+    next_step next() { return { *this }; }
+
+    /**
+     * \brief Skips the next element.
+     *
+     * \return The token after the skipped element. It is also returned by the next `next` or `read`,
+     *         so the code that follows `skip` does not have to handle it.
+     */
+    skip_step skip() { return { *this }; }
+
+    /// Awaits the value of the member of the current object. The key must stay available until the member is found.
+    member find_member(std::string_view key) { return { *this, key }; }
+
+    /// Awaits the value of the member of the current object and collects its text like `read`
+    member find_member(std::string_view key, std::string & out)
+    {
+        out.clear();
+        collect = &out;
+        return { *this, key };
+    }
+
+    /**
+     * \brief Awaits the next token and collects its text.
+     *
+     * The parts of a name, a number or a string that crosses fragments are joined, so the awaited token
+     * is never a part, and `out` gets the complete text. Strings are not unescaped.
+     */
+    next_step read(std::string & out)
+    {
+        out.clear();
+        collect = &out;
+        return { *this };
+    }
+
+    /// Current token text. It is valid until the next fragment is pushed.
+    std::string_view text()
+    {
+        uint16_t length;
+        const char * data = jspp_text(&state, &length);
+        return std::string_view(data, length);
+    }
+
+    /**
+     * \brief Parses the next fragment.
+     *
+     * When the awaited token is found the coroutine is resumed, and this function returns when the
+     * coroutine awaits the token that is not in this fragment or when it returns. The fragment is not
+     * needed after that.
+     */
+    void push(std::string_view fragment)
+    {
+        token = jspp_continue(&state, fragment.data(), (uint16_t) fragment.size());
+        if (settle() && waiting) {
+            std::coroutine_handle<> h = waiting;
+            waiting = nullptr;
+            h.resume();
+        }
+    }
+
+    /// The last token. `JSON_END` once the entire JSON has been parsed.
+    token_t last() const { return token; }
+
+    jspp_t * get() { return &state; }
+
+private:
+    /// Checks whether the token the operation has returned can be awaited without suspension
+    bool begin(token_t result)
+    {
+        token = result;
+        // the common case - a complete token that is not collected - is checked first
+        return (is_element(token) && !collect) || settle();
+    }
+
+    /**
+     * \brief Finishes the awaited token.
+     *
+     * \return true if it is ready, false if the parser needs the next fragment
+     */
+    bool settle()
+    {
+        if (collect) {
+            while (is_part(token)) {
+                collect->append(text());
+                token = jspp_next(&state);
+            }
+        }
+        if (token == JSON_CONTINUE) {
+            return false;
+        }
+        if (collect) {
+            if (JSON_NULL <= token && token <= JSON_FALSE) {
+                // only the last part of a split literal is reported
+                static const char * const literals[] = { "null", "true", "false" };
+                collect->assign(literals[token - JSON_NULL]);
+            } else if (is_element(token)) {
+                collect->append(text());
+            }
+            collect = nullptr;
+        }
+        return true;
+    }
+
+    jspp_t                  state;
+    jspp_search_t           search;             ///< Progress of `find_member`
+    token_t                 token = JSON_CONTINUE;
+    bool                    holding = false;    ///< Set when `skip` has found the token for the next operation
+    std::string *           collect = nullptr;  ///< Receives the text of the token `read` awaits
+    std::coroutine_handle<> waiting;
+};
+
+} // namespace jspp
+
+#endif
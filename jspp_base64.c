@@ -0,0 +1,162 @@
+#include "jspp_base64.h"
+#include <stddef.h>
+
+#define INVALID 0xff
+
+///< Values of the base64 characters of both the standard and the URL-safe alphabets. Other characters are INVALID.
+static const uint8_t values[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0x3e, 0xff, 0x3f,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0x3f,
+    0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+///< Prepares the decoder for the next string
+static void reset(jspp_base64_t * decoder)
+{
+    decoder->quartet = 0;
+    decoder->count = 0;
+    decoder->padding = 0;
+    decoder->escape = 0;
+    decoder->failed = 0;
+    decoder->length = 0;
+}
+
+void jspp_base64_init(jspp_base64_t * decoder, jspp_sink_t sink, void * sink_data)
+{
+    decoder->sink = sink;
+    decoder->sink_data = sink_data;
+    decoder->decoded = 0;
+    reset(decoder);
+}
+
+static void flush(jspp_base64_t * decoder)
+{
+    if (decoder->length > 0) {
+        decoder->sink((const char *) decoder->buffer, decoder->length, decoder->sink_data);
+        decoder->decoded += decoder->length;
+        decoder->length = 0;
+    }
+}
+
+///< Puts the first `size` bytes of the 24-bit group into the buffer
+static inline void put_bytes(jspp_base64_t * decoder, uint32_t group, uint8_t size)
+{
+    if (decoder->length > JSPP_BASE64_BUFFER_SIZE - 3) {
+        flush(decoder);
+    }
+    uint8_t * out = decoder->buffer + decoder->length;
+    out[0] = (uint8_t) (group >> 16);
+    out[1] = (uint8_t) (group >> 8);
+    out[2] = (uint8_t) group;
+    decoder->length += size;
+}
+
+/**
+ * \brief Decodes complete groups of 4 characters.
+ *
+ * Each group is decoded with 4 table lookups and a single check of their combined high bits, so
+ * there are no per-character branches. The loop stops at the first group that has a character
+ * that is not in the alphabet - an escape, padding or an invalid character - which is then handled
+ * one character at a time.
+ */
+static const uint8_t * decode_groups(jspp_base64_t * decoder, const uint8_t * txt, const uint8_t * end)
+{
+    while (end - txt >= 4) {
+        uint8_t a = values[txt[0]];
+        uint8_t b = values[txt[1]];
+        uint8_t c = values[txt[2]];
+        uint8_t d = values[txt[3]];
+        if ((a | b | c | d) & 0x80) {
+            break;
+        }
+        put_bytes(decoder, (uint32_t) a << 18 | (uint32_t) b << 12 | (uint32_t) c << 6 | d, 3);
+        txt += 4;
+    }
+    return txt;
+}
+
+///< Adds the next character to the incomplete group
+static void decode_char(jspp_base64_t * decoder, uint8_t chr)
+{
+    if (decoder->escape) {
+        decoder->escape = 0;
+        if (chr == 'n' || chr == 'r' || chr == 't') {
+            // line breaks of the MIME encoding
+            return;
+        }
+        if (chr != '/') {
+            decoder->failed = 1;
+            return;
+        }
+    } else if (chr == '\\') {
+        decoder->escape = 1;
+        return;
+    } else if (chr == ' ') {
+        return;
+    }
+    if (chr == '=') {
+        // 2 or 3 characters followed by the padding make the last group
+        if (decoder->count + decoder->padding < 2 || decoder->count + decoder->padding >= 4) {
+            decoder->failed = 1;
+        } else {
+            ++decoder->padding;
+        }
+        return;
+    }
+    uint8_t value = values[chr];
+    if (value == INVALID || decoder->padding > 0) {
+        decoder->failed = 1;
+        return;
+    }
+    decoder->quartet = decoder->quartet << 6 | value;
+    if (++decoder->count == 4) {
+        put_bytes(decoder, decoder->quartet, 3);
+        decoder->quartet = 0;
+        decoder->count = 0;
+    }
+}
+
+uint8_t jspp_base64_decode(jspp_base64_t * decoder, jspp_t * parser)
+{
+    uint16_t length;
+    const uint8_t * txt = (const uint8_t *) jspp_text(parser, &length);
+    const uint8_t * const end = txt + length;
+
+    while (txt < end && !decoder->failed) {
+        if (decoder->count == 0 && decoder->padding == 0 && !decoder->escape) {
+            txt = decode_groups(decoder, txt, end);
+            if (txt == end) {
+                break;
+            }
+        }
+        decode_char(decoder, *txt++);
+    }
+
+    uint8_t valid = !decoder->failed;
+    if (parser->token == JSON_STRING) {
+        if (decoder->count == 1 || decoder->escape) {
+            valid = 0;
+        } else if (decoder->count > 1 && valid) {
+            // the last group is 2 or 3 characters, with or without the padding
+            put_bytes(decoder, decoder->quartet << (6 * (4 - decoder->count)), decoder->count - 1);
+        }
+        if (valid) {
+            flush(decoder);
+        }
+        reset(decoder);
+    }
+    return valid;
+}
@@ -0,0 +1,51 @@
+#ifndef __JSPP_BASE64_H
+#define __JSPP_BASE64_H
+
+#include "jspp.h"
+
+#define JSPP_BASE64_BUFFER_SIZE 240 ///< Size of the buffer for the decoded bytes. The sink gets them in chunks of this size.
+
+typedef struct _jspp_base64 {
+    jspp_sink_t sink;
+    void *      sink_data;
+    uint64_t    decoded;    ///< Number of bytes that have been passed to the sink
+    uint32_t    quartet;    ///< Bits of the incomplete group of 4 characters
+    uint8_t     count;      ///< Number of characters in the incomplete group
+    uint8_t     padding;    ///< Number of `=` that have been seen
+    uint8_t     escape;     ///< Set after a backslash
+    uint8_t     failed;     ///< Set when the string is not valid base64
+    uint16_t    length;     ///< Number of bytes in the buffer
+    uint8_t     buffer[JSPP_BASE64_BUFFER_SIZE];
+} jspp_base64_t;
+
+/**
+ * \brief Prepares the base64 decoder.
+ *
+ * \param decoder   A pointer to the decoder struct allocated by the caller
+ * \param sink      The function that receives the decoded bytes
+ * \param sink_data The pointer that is passed to the sink
+ */
+void jspp_base64_init(jspp_base64_t * decoder, jspp_sink_t sink, void * sink_data);
+
+/**
+ * \brief Decodes the current string token as base64.
+ *
+ * \param decoder A pointer to the decoder struct
+ * \param parser  A pointer to the parser that has returned `JSON_STRING_PART` or `JSON_STRING`
+ *
+ * \return 1 if the string so far is valid base64, 0 if it is not
+ *
+ * The decoder is called with every part of a string that spans fragments, and then with the final
+ * `JSON_STRING`. The incomplete group of characters at the end of a part is kept in the decoder, so
+ * the encoded string never has to be collected. Decoded bytes are passed to the sink in chunks of up
+ * to `JSPP_BASE64_BUFFER_SIZE` bytes. The last chunk is passed when the string ends. After that
+ * the decoder is ready for the next string.
+ *
+ * Both the standard and the URL-safe alphabets are accepted. Padding is optional. Escaped slashes
+ * (`\/`) are decoded as slashes, and escaped line breaks and spaces, which some encoders insert, are
+ * ignored. Once the string is found to be invalid the rest of it is ignored and the function returns
+ * 0 until the string ends.
+ */
+uint8_t jspp_base64_decode(jspp_base64_t * decoder, jspp_t * parser);
+
+#endif
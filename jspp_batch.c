@@ -0,0 +1,54 @@
+#include "jspp_batch.h"
+
+#if defined(__GNUC__)
+#define prefetch(ptr) __builtin_prefetch(ptr)
+#else
+#define prefetch(ptr) ((void) (ptr))
+#endif
+
+#define CACHE_LINE_SIZE 64
+
+///< The prefetches of `jspp_batch_run` expect the parser state to span at most 2 lines
+typedef char parser_fits_cache_line[sizeof(jspp_t) <= CACHE_LINE_SIZE ? 1 : -1];
+
+static void run_job(jspp_batch_job_t * job)
+{
+    jspp_t * parser = job->parser;
+    uint8_t token = job->status;
+    if (token <= JSON_CONTINUE) {
+        token = jspp_continue(parser, job->text, job->text_len);
+    }
+    uint16_t count = 0;
+    while (token > JSON_CONTINUE) {
+        if (count == job->capacity) {
+            break;
+        }
+        jspp_batch_token_t * entry = &job->tokens[count++];
+        entry->token = token;
+        entry->start = parser->token_start;
+        entry->length = parser->token_length;
+        token = jspp_next(parser);
+    }
+    job->count = count;
+    job->status = token;
+}
+
+void jspp_batch_run(jspp_batch_job_t * jobs, uint32_t num_jobs)
+{
+    // the prefetches stay in this loop: moved into a helper, GCC treats the helper as free of side effects
+    // and drops the calls once it is too big to inline
+    for (uint32_t i = 0; i < num_jobs + JSPP_BATCH_PREFETCH_DISTANCE; i++) {
+        if (i < num_jobs) {
+            const jspp_batch_job_t * job = &jobs[i];
+            const char * parser = (const char *) job->parser;
+            // the parser state fits into a line, but it does not have to start at the beginning of one
+            prefetch(parser);
+            prefetch(parser + sizeof(jspp_t) - 1);
+            prefetch(job->text);
+            prefetch(job->tokens);
+        }
+        if (i >= JSPP_BATCH_PREFETCH_DISTANCE) {
+            run_job(&jobs[i - JSPP_BATCH_PREFETCH_DISTANCE]);
+        }
+    }
+}
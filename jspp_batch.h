@@ -0,0 +1,52 @@
+#ifndef __JSPP_BATCH_H
+#define __JSPP_BATCH_H
+
+#include "jspp.h"
+
+#define JSPP_BATCH_PREFETCH_DISTANCE 4 ///< How many jobs ahead the engine prefetches the stream state
+
+/// A token recognized by the batch engine
+typedef struct _jspp_batch_token {
+    uint16_t    start;      ///< Index of the first character of the token text in the fragment
+    uint16_t    length;     ///< Token text length
+    uint8_t     token;
+} jspp_batch_token_t;
+
+/// A fragment of one stream
+typedef struct _jspp_batch_job {
+    jspp_t *                parser;     ///< Parser of the stream
+    const char *            text;       ///< The next JSON text fragment of the stream
+    uint16_t                text_len;
+    uint16_t                capacity;   ///< Number of tokens the `tokens` array can hold
+    jspp_batch_token_t *    tokens;     ///< Caller supplied array that receives the tokens
+    uint16_t                count;      ///< Number of tokens that have been recorded
+    uint8_t                 status;     ///< Why the engine stopped processing the fragment
+} jspp_batch_job_t;
+
+/**
+ * \brief Parses fragments of many streams.
+ *
+ * \param jobs     An array of jobs - one fragment per stream
+ * \param num_jobs Number of jobs in the array
+ *
+ * When a service handles thousands of streams, the state of each parser is most likely not in the
+ * cache when the next fragment of its stream arrives. This function processes a batch of fragments
+ * and prefetches the parser state and the text of the jobs that are `JSPP_BATCH_PREFETCH_DISTANCE`
+ * positions ahead, so these loads overlap with the parsing of the current job.
+ *
+ * The tokens of each fragment are recorded in the job's `tokens` array. The job `status` is set to:
+ * - `JSON_CONTINUE` when the entire fragment has been processed and the stream needs the next one,
+ * - `JSON_END`, `JSON_INVALID` or `JSON_TOO_DEEP` like they are returned by `jspp_next`,
+ * - the token that did not fit when the `tokens` array is full. Once the caller has processed the
+ *   recorded tokens it can run the job again (without changing the text) to continue with this token.
+ *
+ * A job is resumed when its `status` is a token - greater than `JSON_CONTINUE`. Otherwise the job text
+ * is passed to the parser as the next fragment of the stream. Thus streams should be started with an
+ * empty initial fragment - `jspp_start(&parser, "", 0)` - and `status` set to `JSON_CONTINUE`.
+ *
+ * Note that the recorded tokens reference the text of the fragment, which must remain valid until
+ * the caller has processed them.
+ */
+void jspp_batch_run(jspp_batch_job_t * jobs, uint32_t num_jobs);
+
+#endif
@@ -0,0 +1,303 @@
+#include "jspp_bind.h"
+#include "jspp_conv.h"
+
+///< Marks the collected text as too long to be of any use.
+#define TEXT_OVERFLOW (JSPP_BIND_TEXT_SIZE + 1)
+
+void jspp_bind_init(jspp_bind_t * binding, const jspp_bind_field_t * fields, void * target)
+{
+    binding->member = NULL;
+    binding->frames[0].fields = fields;
+    binding->frames[0].array = NULL;
+    binding->frames[0].base = target;
+    binding->depth = 0;
+    binding->started = 0;
+    binding->text_length = 0;
+}
+
+///< Appends the text of the current (partial) token to the side buffer
+static void collect_text(jspp_bind_t * binding)
+{
+    uint16_t length;
+    const char * text = jspp_text(&binding->parser, &length);
+    if (binding->text_length + length > JSPP_BIND_TEXT_SIZE) {
+        binding->text_length = TEXT_OVERFLOW;
+        return;
+    }
+    char * dst = binding->text + binding->text_length;
+    for (uint16_t i = 0; i < length; i++) {
+        dst[i] = text[i];
+    }
+    binding->text_length += length;
+}
+
+/**
+ * \brief Returns the complete text of the current token.
+ *
+ * \param      binding A pointer to the binding
+ * \param[out] length  A pointer to the variable in which the length of the token text will be returned
+ *
+ * \return Pointer to the token text or NULL if the text did not fit into the side buffer.
+ *
+ * If the token was split between fragments, then its text is assembled in the binding side buffer.
+ * Otherwise the returned text points into the current fragment.
+ */
+static const char * token_text(jspp_bind_t * binding, uint16_t * length)
+{
+    if (binding->text_length == 0) {
+        return jspp_text(&binding->parser, length);
+    }
+    collect_text(binding);
+    *length = binding->text_length;
+    binding->text_length = 0;
+    return *length <= JSPP_BIND_TEXT_SIZE ? binding->text : NULL;
+}
+
+static const jspp_bind_field_t * find_field(const jspp_bind_field_t * field, const char * name, uint16_t length)
+{
+    for (; field->name; field++) {
+        uint16_t i = 0;
+        while (i < length && field->name[i] == name[i]) {
+            ++i;
+        }
+        if (i == length && field->name[i] == '\0') {
+            return field;
+        }
+    }
+    return NULL;
+}
+
+///< Returns true if the number has been stored. Otherwise `dst` is left as is.
+static int store_number(uint8_t type, uint8_t token, const char * text, uint16_t length, uint8_t * dst)
+{
+    int64_t i;
+    double d;
+
+    if (type == JSPP_BIND_DOUBLE) {
+        if (!jspp_scan_double(text, length, &d)) {
+            return 0;
+        }
+        *(double *) dst = d;
+        return 1;
+    }
+    if (token == JSON_INTEGER) {
+        if (!jspp_scan_int64(text, length, &i)) {
+            return 0;
+        }
+    } else {
+        // decimal and floating point numbers are truncated when stored in integers
+        if (!jspp_scan_double(text, length, &d) || !(-9.2e18 < d && d < 9.2e18)) {
+            return 0;
+        }
+        i = (int64_t) d;
+    }
+    if (type == JSPP_BIND_INT64) {
+        *(int64_t *) dst = i;
+        return 1;
+    }
+    if (INT32_MIN <= i && i <= INT32_MAX) {
+        *(int32_t *) dst = (int32_t) i;
+        return 1;
+    }
+    return 0;
+}
+
+///< Appends the text of the current string token to the bound char array
+static void store_string(jspp_bind_t * binding, uint16_t size, uint8_t * dst)
+{
+    uint16_t length;
+    const char * text = jspp_text(&binding->parser, &length);
+    char * str = (char *) dst;
+    uint16_t pos = binding->text_length;
+    for (uint16_t i = 0; i < length && pos + 1 < size; i++) {
+        str[pos++] = text[i];
+    }
+    if (size > 0) {
+        str[pos] = '\0';
+    }
+    binding->text_length = pos;
+}
+
+static inline int is_number_type(uint8_t type)
+{
+    return type == JSPP_BIND_INT32 || type == JSPP_BIND_INT64 || type == JSPP_BIND_DOUBLE;
+}
+
+/**
+ * \brief Records that the value of the current member or array element has been processed.
+ *
+ * \param binding A pointer to the binding
+ * \param stored  True if the value has been stored. Array elements that have not been stored are
+ *                not counted, so the next element takes their slot.
+ */
+static void value_done(jspp_bind_t * binding, int stored)
+{
+    jspp_bind_frame_t * frame = &binding->frames[binding->depth];
+    if (frame->array) {
+        if (stored) {
+            ++*(uint16_t *) (frame->base + frame->array->count_offset);
+        }
+    } else {
+        binding->member = NULL;
+    }
+    binding->text_length = 0;
+}
+
+///< Skips the value that cannot be bound
+static uint8_t skip_value(jspp_bind_t * binding)
+{
+    value_done(binding, 0);
+    return jspp_skip(&binding->parser);
+}
+
+static uint8_t bind_member_name(jspp_bind_t * binding, uint8_t token)
+{
+    jspp_t * parser = &binding->parser;
+
+    switch (token) {
+        case JSON_MEMBER_NAME_PART: {
+            collect_text(binding);
+            return jspp_next(parser);
+        }
+        case JSON_MEMBER_NAME: {
+            uint16_t length;
+            const char * name = token_text(binding, &length);
+            const jspp_bind_field_t * field = name ? find_field(binding->frames[binding->depth].fields, name, length) : NULL;
+            if (!field) {
+                // skips the member value
+                return jspp_skip(parser);
+            }
+            binding->member = field;
+            return jspp_next(parser);
+        }
+        case JSON_OBJECT_END: {
+            --binding->depth;
+            return jspp_next(parser);
+        }
+    }
+    return JSON_INVALID;
+}
+
+static uint8_t bind_value(jspp_bind_t * binding, uint8_t token)
+{
+    jspp_t * parser = &binding->parser;
+    jspp_bind_frame_t * frame = &binding->frames[binding->depth];
+    const jspp_bind_field_t * field;
+    uint8_t type;
+    uint8_t * dst;
+
+    if (binding->depth == 0) {
+        if (token != JSON_OBJECT_BEGIN) {
+            return JSON_INVALID;
+        }
+        binding->frames[1] = *frame;
+        binding->depth = 1;
+        return jspp_next(parser);
+    }
+    if (frame->array) {
+        if (token == JSON_ARRAY_END) {
+            --binding->depth;
+            return jspp_next(parser);
+        }
+        field = frame->array;
+        uint16_t index = *(uint16_t *) (frame->base + field->count_offset);
+        if (index >= field->capacity) {
+            return jspp_skip(parser);
+        }
+        type = field->element_type;
+        dst = frame->base + field->offset + index * field->size;
+    } else {
+        field = binding->member;
+        type = field->type;
+        dst = frame->base + field->offset;
+    }
+
+    int stored = 0;
+    switch (token) {
+        case JSON_OBJECT_BEGIN: {
+            if (type != JSPP_BIND_OBJECT) {
+                return skip_value(binding);
+            }
+            value_done(binding, 1);
+            frame = &binding->frames[++binding->depth];
+            frame->fields = field->fields;
+            frame->array = NULL;
+            frame->base = dst;
+            return jspp_next(parser);
+        }
+        case JSON_ARRAY_BEGIN: {
+            if (type != JSPP_BIND_ARRAY || frame->array) {
+                return skip_value(binding);
+            }
+            uint8_t * base = frame->base;
+            value_done(binding, 1);
+            *(uint16_t *) (base + field->count_offset) = 0;
+            frame = &binding->frames[++binding->depth];
+            frame->fields = NULL;
+            frame->array = field;
+            frame->base = base;
+            return jspp_next(parser);
+        }
+        case JSON_NUMBER_PART: {
+            if (!is_number_type(type)) {
+                return skip_value(binding);
+            }
+            collect_text(binding);
+            return jspp_next(parser);
+        }
+        case JSON_INTEGER:
+        case JSON_DECIMAL:
+        case JSON_FLOATING_POINT: {
+            if (is_number_type(type)) {
+                uint16_t length;
+                const char * text = token_text(binding, &length);
+                stored = text && store_number(type, token, text, length, dst);
+            }
+            break;
+        }
+        case JSON_STRING_PART: {
+            if (type != JSPP_BIND_STRING) {
+                return skip_value(binding);
+            }
+            store_string(binding, field->size, dst);
+            return jspp_next(parser);
+        }
+        case JSON_STRING: {
+            if (type == JSPP_BIND_STRING) {
+                store_string(binding, field->size, dst);
+                stored = 1;
+            }
+            break;
+        }
+        case JSON_TRUE:
+        case JSON_FALSE: {
+            if (type == JSPP_BIND_BOOL) {
+                *dst = token == JSON_TRUE;
+                stored = 1;
+            }
+            break;
+        }
+    }
+    value_done(binding, stored);
+    return jspp_next(parser);
+}
+
+uint8_t jspp_bind_feed(jspp_bind_t * binding, const char * text, uint16_t text_len)
+{
+    uint8_t token;
+    if (!binding->started) {
+        binding->started = 1;
+        token = jspp_start(&binding->parser, text, text_len);
+    } else {
+        token = jspp_continue(&binding->parser, text, text_len);
+    }
+
+    while (token > JSON_CONTINUE) {
+        if (binding->depth > 0 && !binding->frames[binding->depth].array && !binding->member) {
+            token = bind_member_name(binding, token);
+        } else {
+            token = bind_value(binding, token);
+        }
+    }
+    return token;
+}
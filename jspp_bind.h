@@ -0,0 +1,116 @@
+#ifndef __JSPP_BIND_H
+#define __JSPP_BIND_H
+
+#include "jspp.h"
+#include <stddef.h>
+
+#ifndef JSPP_BIND_TEXT_SIZE
+#define JSPP_BIND_TEXT_SIZE 32  ///< Size of the buffer that collects member names and numbers split between fragments
+#endif
+
+enum _jspp_bind_types {
+    JSPP_BIND_BOOL,     ///< uint8_t that is set to 1 for `true` and to 0 for `false`
+    JSPP_BIND_INT32,    ///< int32_t
+    JSPP_BIND_INT64,    ///< int64_t
+    JSPP_BIND_DOUBLE,   ///< double
+    JSPP_BIND_STRING,   ///< char array. The string is stored as it appears in JSON (escapes are not decoded),
+                        ///< truncated to fit, and is always `\0` terminated.
+    JSPP_BIND_OBJECT,   ///< Nested struct described by its own field table
+    JSPP_BIND_ARRAY     ///< Array of any of the above (except arrays) with a fixed capacity
+};
+
+/**
+ * Describes how a JSON object member is bound to a member of a C struct.
+ *
+ * Field tables are arrays of these terminated by an entry with a NULL `name`. They are not
+ * usually written by hand. Instead use `JSPP_BIND_FIELD`, `JSPP_BIND_STRING_FIELD`,
+ * `JSPP_BIND_OBJECT_FIELD`, `JSPP_BIND_ARRAY_FIELD` and `JSPP_BIND_END` macros:
+ *
+ *     typedef struct _point { int32_t x, y; } point_t;
+ *     typedef struct _shape {
+ *         char     name[16];
+ *         point_t  points[8];
+ *         uint16_t num_points;
+ *     } shape_t;
+ *
+ *     static const jspp_bind_field_t point_fields[] = {
+ *         JSPP_BIND_FIELD(point_t, x, JSPP_BIND_INT32),
+ *         JSPP_BIND_FIELD(point_t, y, JSPP_BIND_INT32),
+ *         JSPP_BIND_END
+ *     };
+ *     static const jspp_bind_field_t shape_fields[] = {
+ *         JSPP_BIND_STRING_FIELD(shape_t, name),
+ *         JSPP_BIND_ARRAY_FIELD(shape_t, points, num_points, JSPP_BIND_OBJECT, point_fields),
+ *         JSPP_BIND_END
+ *     };
+ */
+typedef struct _jspp_bind_field {
+    const char *    name;           ///< JSON object member name
+    uint16_t        offset;         ///< Offset of the bound member in the struct
+    uint16_t        size;           ///< STRING: buffer size. OBJECT: size of the struct. ARRAY: size of one element
+    uint16_t        capacity;       ///< ARRAY: maximum number of elements
+    uint16_t        count_offset;   ///< ARRAY: offset of the `uint16_t` that receives the number of elements
+    uint8_t         type;           ///< One of the `_jspp_bind_types`
+    uint8_t         element_type;   ///< ARRAY: type of the array elements
+    const struct _jspp_bind_field * fields; ///< OBJECT or ARRAY of OBJECTs: field table of the nested struct
+} jspp_bind_field_t;
+
+#define JSPP_BIND_FIELD(s, m, t) \
+    { #m, offsetof(s, m), sizeof(((s *) 0)->m), 0, 0, t, 0, NULL }
+#define JSPP_BIND_STRING_FIELD(s, m) \
+    { #m, offsetof(s, m), sizeof(((s *) 0)->m), 0, 0, JSPP_BIND_STRING, 0, NULL }
+#define JSPP_BIND_OBJECT_FIELD(s, m, f) \
+    { #m, offsetof(s, m), sizeof(((s *) 0)->m), 0, 0, JSPP_BIND_OBJECT, 0, f }
+#define JSPP_BIND_ARRAY_FIELD(s, m, n, t, f) \
+    { #m, offsetof(s, m), sizeof(((s *) 0)->m[0]), sizeof(((s *) 0)->m) / sizeof(((s *) 0)->m[0]), offsetof(s, n), JSPP_BIND_ARRAY, t, f }
+#define JSPP_BIND_END \
+    { NULL, 0, 0, 0, 0, 0, 0, NULL }
+
+///< Bound object or array that is being parsed.
+typedef struct _jspp_bind_frame {
+    const jspp_bind_field_t *   fields; ///< OBJECT: field table of the struct
+    const jspp_bind_field_t *   array;  ///< ARRAY: the array field. NULL for objects.
+    uint8_t *                   base;   ///< OBJECT: the struct. ARRAY: the struct that contains the array.
+} jspp_bind_frame_t;
+
+typedef struct _jspp_bind {
+    jspp_t                      parser;
+    const jspp_bind_field_t *   member;         ///< Field that receives the value of the current object member
+    jspp_bind_frame_t           frames[JSON_MAX_STACK]; ///< The first frame describes the target struct itself
+    uint8_t                     depth;          ///< Number of open bound objects and arrays
+    uint8_t                     started;
+    uint16_t                    text_length;    ///< Length of the text collected so far. For strings - number of
+                                                ///< characters already stored in the target buffer.
+    char                        text[JSPP_BIND_TEXT_SIZE];
+} jspp_bind_t;
+
+/**
+ * \brief Prepares the binding to parse JSON into the target struct.
+ *
+ * \param binding A pointer to the binding struct allocated by the caller
+ * \param fields  The field table that describes the target struct
+ * \param target  The struct that will receive the data
+ *
+ * Note that the binding only sets the members for which it finds values. The caller is expected
+ * to initialize the target struct with defaults before the parsing starts.
+ */
+void jspp_bind_init(jspp_bind_t * binding, const jspp_bind_field_t * fields, void * target);
+
+/**
+ * \brief Parses the next JSON fragment and stores the recognized values in the target struct.
+ *
+ * \param binding  A pointer to the binding initialized by `jspp_bind_init`
+ * \param text     The next JSON text fragment
+ * \param text_len The length of the text
+ *
+ * \return `JSON_CONTINUE` when the next fragment is needed, `JSON_END` when the entire JSON has been
+ *         processed, or `JSON_INVALID`/`JSON_TOO_DEEP` when the JSON cannot be parsed.
+ *
+ * The top level JSON element must be an object. Members that are not described by the field tables,
+ * values that cannot be stored in the bound member (an object for a number for instance), as well as
+ * array elements that exceed the array capacity, are skipped. Skipped array elements are not counted,
+ * so the stored ones occupy the first `count` slots of the array.
+ */
+uint8_t jspp_bind_feed(jspp_bind_t * binding, const char * text, uint16_t text_len);
+
+#endif
@@ -0,0 +1,453 @@
+#include "jspp_conv.h"
+#include "jspp_swar.h"
+#include <stddef.h>
+
+#define MAX_EXACT_POW10 22
+#define MAX_EXACT_INT   (1ull << 53)
+
+static const double powers_of_10[MAX_EXACT_POW10 + 1] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+///< Multipliers that make room for the runs of 0 to 8 digits
+static const uint32_t digit_scales[9] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+static inline int is_digit(char c)
+{
+    return '0' <= c && c <= '9';
+}
+
+uint16_t jspp_scan_int64(const char * text, uint16_t text_len, int64_t * value)
+{
+    const char * ptr = text;
+    const char * const end = text + text_len;
+
+    int negative = ptr < end && *ptr == '-';
+    if (negative) {
+        ++ptr;
+    }
+    if (ptr == end || !is_digit(*ptr)) {
+        return 0;
+    }
+    const uint64_t limit = negative ? (uint64_t) INT64_MAX + 1 : (uint64_t) INT64_MAX;
+    uint64_t v = 0;
+    // digits are converted up to 8 at a time while they cannot overflow
+    while (end - ptr >= 8 && v <= (limit - 99999999) / 100000000) {
+        uint64_t word = swar_load64(ptr);
+        unsigned count = swar_leading_digits(word);
+        if (count == 0) {
+            break;
+        }
+        v = v * digit_scales[count] + swar_digits_value(word, count);
+        ptr += count;
+        if (count < 8) {
+            break;
+        }
+    }
+    while (ptr < end && is_digit(*ptr)) {
+        uint8_t d = *ptr++ - '0';
+        if (v > (limit - d) / 10) {
+            return 0;
+        }
+        v = v * 10 + d;
+    }
+    *value = negative ? (int64_t) (0 - v) : (int64_t) v;
+    return ptr - text;
+}
+
+///< Scales the significand by the power of 10. The result might be off by a few units in the last place.
+static double scale(double v, int exp10)
+{
+    while (exp10 > MAX_EXACT_POW10) {
+        v *= powers_of_10[MAX_EXACT_POW10];
+        exp10 -= MAX_EXACT_POW10;
+    }
+    while (exp10 < -MAX_EXACT_POW10) {
+        v /= powers_of_10[MAX_EXACT_POW10];
+        exp10 += MAX_EXACT_POW10;
+    }
+    return exp10 < 0 ? v / powers_of_10[-exp10] : v * powers_of_10[exp10];
+}
+
+#define DP_SIGNIFICAND_SIZE 52
+#define DP_SIGNIFICAND_MASK 0x000fffffffffffffull
+#define DP_HIDDEN_BIT       0x0010000000000000ull
+#define DP_EXPONENT_BIAS    (0x3ff + DP_SIGNIFICAND_SIZE)
+#define DP_MIN_EXPONENT     (1 - DP_EXPONENT_BIAS)
+#define DP_INFINITY         0x7ff0000000000000ull
+
+#define MAX_BIG_DIGITS  780 ///< Digits past these cannot change the rounding, they can only break a tie
+#define BIG_LIMBS       90  ///< Enough for the digits and the powers of 5 they are compared with
+
+///< Unsigned integer that is large enough to hold any JSON number exactly
+typedef struct _big {
+    uint32_t    limbs[BIG_LIMBS];   ///< Least significant limb first
+    uint16_t    length;             ///< Number of limbs in use. 0 for zero.
+} big_t;
+
+static void big_set(big_t * b, uint64_t v)
+{
+    b->limbs[0] = (uint32_t) v;
+    b->limbs[1] = (uint32_t) (v >> 32);
+    b->length = v >> 32 ? 2 : v != 0;
+}
+
+///< Sets b = b * m + a
+static void big_mul_add(big_t * b, uint32_t m, uint32_t a)
+{
+    uint64_t carry = a;
+    for (uint16_t i = 0; i < b->length; i++) {
+        carry += (uint64_t) b->limbs[i] * m;
+        b->limbs[i] = (uint32_t) carry;
+        carry >>= 32;
+    }
+    if (carry) {
+        b->limbs[b->length++] = (uint32_t) carry;
+    }
+}
+
+///< Multiplies by 5^k
+static void big_mul_pow5(big_t * b, int k)
+{
+    static const uint32_t powers_of_5[14] = {
+        1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625, 48828125, 244140625, 1220703125
+    };
+    for (; k >= 13; k -= 13) {
+        big_mul_add(b, powers_of_5[13], 0);
+    }
+    if (k > 0) {
+        big_mul_add(b, powers_of_5[k], 0);
+    }
+}
+
+static void big_shift_left(big_t * b, int bits)
+{
+    if (b->length == 0 || bits == 0) {
+        return;
+    }
+    uint16_t limbs = bits / 32;
+    bits %= 32;
+    b->limbs[b->length] = 0;
+    for (int i = b->length; i >= 0; i--) {
+        uint32_t v = b->limbs[i] << bits;
+        if (bits && i > 0) {
+            v |= b->limbs[i - 1] >> (32 - bits);
+        }
+        b->limbs[i + limbs] = v;
+    }
+    for (uint16_t i = 0; i < limbs; i++) {
+        b->limbs[i] = 0;
+    }
+    b->length += limbs + 1;
+    if (b->limbs[b->length - 1] == 0) {
+        --b->length;
+    }
+}
+
+static int big_compare(const big_t * a, const big_t * b)
+{
+    if (a->length != b->length) {
+        return a->length < b->length ? -1 : 1;
+    }
+    for (int i = a->length - 1; i >= 0; i--) {
+        if (a->limbs[i] != b->limbs[i]) {
+            return a->limbs[i] < b->limbs[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief Collects the significant digits of the number into a big integer.
+ *
+ * \param[out]    n     The big integer
+ * \param         ptr   The first digit of the number
+ * \param         end   The end of the digits and the decimal point
+ * \param[in,out] exp10 The exponent that follows the digits. It is adjusted so that the value is `n * 10^exp10`.
+ *
+ * \return The number of significant digits in `n`
+ */
+static int big_from_digits(big_t * n, const char * ptr, const char * end, int * exp10)
+{
+    big_set(n, 0);
+    int num_digits = 0;
+    int fraction = 0;
+    int sticky = 0;
+    uint32_t chunk = 0;
+    int chunk_length = 0;
+    for (; ptr < end; ++ptr) {
+        if (*ptr == '.') {
+            fraction = 1;
+            continue;
+        }
+        if (fraction) {
+            --*exp10;
+        }
+        if (num_digits == MAX_BIG_DIGITS) {
+            ++*exp10;
+            sticky |= *ptr != '0';
+            continue;
+        }
+        if (num_digits == 0 && *ptr == '0') {
+            continue;
+        }
+        chunk = chunk * 10 + (*ptr - '0');
+        ++num_digits;
+        if (++chunk_length == 8) {
+            big_mul_add(n, digit_scales[8], chunk);
+            chunk = 0;
+            chunk_length = 0;
+        }
+    }
+    big_mul_add(n, digit_scales[chunk_length], chunk);
+    if (sticky) {
+        // the dropped digits only tell that the value is a bit above the digits that are kept
+        big_mul_add(n, 10, 1);
+        ++num_digits;
+        --*exp10;
+    }
+    return num_digits;
+}
+
+typedef union {
+    double      d;
+    uint64_t    u;
+} dp_bits_t;
+
+/**
+ * \brief Compares the number with the point halfway between two neighbouring doubles.
+ *
+ * \param n  The number scaled as `n * 5^max(exp10, 0) * 2^(exp10 - r)`
+ * \param r  The power of 2 the number and the halfway point are scaled by
+ * \param h  The halfway point is `h * 2^e2`
+ * \param e2 The binary exponent of the halfway point
+ * \param k  `-exp10` when it is positive. Otherwise 0.
+ * \param b  Space for the scaled halfway point
+ *
+ * \return Negative, zero or positive when the number is less, equal or greater than the halfway point
+ */
+static int compare_halfway(const big_t * n, int r, uint64_t h, int e2, int k, big_t * b)
+{
+    big_set(b, h);
+    big_mul_pow5(b, k);
+    big_shift_left(b, e2 - r);
+    return big_compare(n, b);
+}
+
+/**
+ * \brief Corrects the approximation of `n * 10^exp10` to the correctly rounded double.
+ *
+ * \param n      The digits of the number. It is modified.
+ * \param exp10  The decimal exponent
+ * \param approx The approximation of the positive number that is off by a few units in the last place at most
+ *
+ * The number is compared with the points halfway between the approximation and its neighbours. Both
+ * are scaled to integers for that, so the comparison is exact. Then the approximation is moved one
+ * unit in the last place at a time towards the number.
+ */
+static double correct_rounding(big_t * n, int exp10, double approx)
+{
+    big_t b;
+    dp_bits_t z = { approx };
+    if (z.u >= DP_INFINITY) {
+        // the largest double
+        z.u = DP_INFINITY - 1;
+    }
+    int k = 0;
+    if (exp10 >= 0) {
+        big_mul_pow5(n, exp10);
+    } else {
+        k = -exp10;
+    }
+    // Both the number and the halfway points are scaled by 2^-r. The halfway points are 1 bit below
+    // the significand, 2 bits below a power of 2, and the approximation might move to the binade below.
+    int e2 = z.u >> DP_SIGNIFICAND_SIZE ? (int) (z.u >> DP_SIGNIFICAND_SIZE) - DP_EXPONENT_BIAS : DP_MIN_EXPONENT;
+    int r = e2 - 4 < exp10 ? e2 - 4 : exp10;
+    big_shift_left(n, exp10 - r);
+
+    for (;;) {
+        uint64_t m = z.u & DP_SIGNIFICAND_MASK;
+        int biased_e = (int) (z.u >> DP_SIGNIFICAND_SIZE);
+        e2 = biased_e ? biased_e - DP_EXPONENT_BIAS : DP_MIN_EXPONENT;
+        if (biased_e) {
+            m |= DP_HIDDEN_BIT;
+        }
+        int c = compare_halfway(n, r, 2 * m + 1, e2 - 1, k, &b);
+        if (c > 0 || (c == 0 && (m & 1))) {
+            if (++z.u == DP_INFINITY) {
+                break;
+            }
+            continue;
+        }
+        if (m == 0) {
+            break;
+        }
+        // the double below a power of 2 is closer than the one above it
+        c = m == DP_HIDDEN_BIT && biased_e > 1
+            ? compare_halfway(n, r, 4 * m - 1, e2 - 2, k, &b)
+            : compare_halfway(n, r, 2 * m - 1, e2 - 1, k, &b);
+        if (c < 0 || (c == 0 && (m & 1))) {
+            --z.u;
+            continue;
+        }
+        break;
+    }
+    return z.d;
+}
+
+/**
+ * \brief Converts the number that cannot be converted with a single floating point operation.
+ *
+ * \param digits          The digits of the number when some of them have not been accumulated in the
+ *                        significand. NULL if the significand has all of them.
+ * \param digits_end      The end of the digits
+ * \param significand     The significand
+ * \param num_significant The number of significant digits in the significand
+ * \param exp10           The decimal exponent of the significand or, when `digits` are given, the
+ *                        exponent that follows the digits
+ * \param approx          The approximation of the number
+ */
+static double convert_exactly(const char * digits, const char * digits_end, uint64_t significand,
+    int num_significant, int exp10, double approx)
+{
+    big_t n;
+    if (digits) {
+        num_significant = big_from_digits(&n, digits, digits_end, &exp10);
+    } else {
+        big_set(&n, significand);
+    }
+    if (num_significant + exp10 < -324) {
+        // less than a half of the smallest subnormal number
+        return 0.0;
+    }
+    if (num_significant + exp10 > 310) {
+        dp_bits_t infinity = { 0.0 };
+        infinity.u = DP_INFINITY;
+        return infinity.d;
+    }
+    return correct_rounding(&n, exp10, approx);
+}
+
+/**
+ * \brief Accumulates a run of digits in the significand.
+ *
+ * \param         ptr             Pointer to the first digit
+ * \param         end             The end of the text
+ * \param[in,out] significand     The significand
+ * \param[in,out] num_significant Number of digits in the significand, not counting the leading zeros
+ * \param[out]    num_kept        Number of digits that have been added to the significand
+ *
+ * \return Pointer to the first character after the run
+ *
+ * Only the first 19 significant digits are kept as they always fit into 64 bits. Runs that start
+ * with a significant digit are added to the significand up to 8 digits at a time while they fit.
+ */
+static inline const char * scan_digits(const char * ptr, const char * end, uint64_t * significand, int * num_significant, int * num_kept)
+{
+    const char * const start = ptr;
+    uint64_t v = *significand;
+    int sig = *num_significant;
+    int kept = 0;
+    if (ptr < end && (v != 0 || *ptr != '0')) {
+        while (end - ptr >= 8 && sig <= 19 - 8) {
+            uint64_t word = swar_load64(ptr);
+            unsigned count = swar_leading_digits(word);
+            if (count == 0) {
+                break;
+            }
+            v = v * digit_scales[count] + swar_digits_value(word, count);
+            ptr += count;
+            sig += count;
+            if (count < 8) {
+                break;
+            }
+        }
+        kept = ptr - start;
+    }
+    while (ptr < end && is_digit(*ptr)) {
+        if (sig < 19) {
+            v = v * 10 + (*ptr - '0');
+            sig += v != 0;
+            ++kept;
+        }
+        ++ptr;
+    }
+    *significand = v;
+    *num_significant = sig;
+    *num_kept = kept;
+    return ptr;
+}
+
+uint16_t jspp_scan_double(const char * text, uint16_t text_len, double * value)
+{
+    const char * ptr = text;
+    const char * const end = text + text_len;
+
+    int negative = ptr < end && *ptr == '-';
+    if (negative) {
+        ++ptr;
+    }
+
+    // Only the first 19 significant digits are accumulated as they always fit into 64 bits.
+    // Digits past those only affect the exponent.
+    uint64_t significand = 0;
+    int num_digits = 0;
+    int num_significant = 0;
+    int exp10 = 0;
+
+    int num_kept;
+    int num_dropped;
+
+    const char * const digits = ptr;
+    ptr = scan_digits(ptr, end, &significand, &num_significant, &num_kept);
+    num_digits += ptr - digits;
+    // integer digits that did not fit still count
+    num_dropped = (ptr - digits) - num_kept;
+    exp10 += num_dropped;
+    if (ptr < end && *ptr == '.') {
+        const char * run = ++ptr;
+        ptr = scan_digits(ptr, end, &significand, &num_significant, &num_kept);
+        num_digits += ptr - run;
+        num_dropped += (ptr - run) - num_kept;
+        exp10 -= num_kept;
+    }
+    const char * const digits_end = ptr;
+    if (num_digits == 0) {
+        return 0;
+    }
+    int exp = 0;
+    if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+        const char * exp_ptr = ptr + 1;
+        int exp_negative = exp_ptr < end && *exp_ptr == '-';
+        if (exp_ptr < end && (*exp_ptr == '-' || *exp_ptr == '+')) {
+            ++exp_ptr;
+        }
+        if (exp_ptr < end && is_digit(*exp_ptr)) {
+            while (exp_ptr < end && is_digit(*exp_ptr)) {
+                if (exp < 10000) {
+                    exp = exp * 10 + (*exp_ptr - '0');
+                }
+                ++exp_ptr;
+            }
+            exp = exp_negative ? -exp : exp;
+            exp10 += exp;
+            ptr = exp_ptr;
+        }
+    }
+
+    double v = (double) significand;
+    if (significand > MAX_EXACT_INT || (significand != 0 && (exp10 < -MAX_EXACT_POW10 || exp10 > MAX_EXACT_POW10))) {
+        v = num_dropped
+            ? convert_exactly(digits, digits_end, significand, num_significant, exp, scale(v, exp10))
+            : convert_exactly(NULL, NULL, significand, num_significant, exp10, scale(v, exp10));
+    } else if (significand != 0 && exp10 != 0) {
+        // Both the significand and the power of 10 are exact. IEEE guarantees that the result
+        // of a single multiplication or division is correctly rounded.
+        v = exp10 < 0 ? v / powers_of_10[-exp10] : v * powers_of_10[exp10];
+    }
+    *value = negative ? -v : v;
+    return ptr - text;
+}
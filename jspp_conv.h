@@ -0,0 +1,38 @@
+#ifndef __JSPP_CONV_H
+#define __JSPP_CONV_H
+
+#include <stdint.h>
+
+/**
+ * \brief Converts the text of a JSON number into a 64-bit integer.
+ *
+ * \param      text     Pointer to the number text (for example, as returned by `jspp_text`)
+ * \param      text_len The length of the text
+ * \param[out] value    Pointer to the variable where the converted value will be stored
+ *
+ * \return The number of characters that were converted. 0 if the text does not start with
+ *         an integer or if the integer does not fit into 64 bits.
+ *
+ * The conversion stops at the first character that cannot be a part of an integer. Thus
+ * for decimal and floating point numbers only the integer part will be converted.
+ */
+uint16_t jspp_scan_int64(const char * text, uint16_t text_len, int64_t * value);
+
+/**
+ * \brief Converts the text of a JSON number into a double.
+ *
+ * \param      text     Pointer to the number text
+ * \param      text_len The length of the text
+ * \param[out] value    Pointer to the variable where the converted value will be stored
+ *
+ * \return The number of characters that were converted. 0 if the text does not start with a number.
+ *
+ * The result is correctly rounded (to nearest, ties to even) like `strtod` would round it. Numbers
+ * that have up to 15 significant digits and a decimal exponent within +/-22 are converted with a
+ * single floating point operation. Other numbers are approximated and the approximation is then
+ * corrected by comparing the number with the neighbouring doubles exactly as big integers. That
+ * takes up to ~1 KB of stack.
+ */
+uint16_t jspp_scan_double(const char * text, uint16_t text_len, double * value);
+
+#endif
@@ -0,0 +1,368 @@
+#include "jspp_filter.h"
+#include <stddef.h>
+
+// Member name matcher states
+#define NAME_NONE       0   ///< The member name has not started yet
+#define NAME_MATCHING   1   ///< The name is being matched against the paths
+#define NAME_WRITING    2   ///< The member is kept and the rest of its name is copied
+#define NAME_HOLDING    3   ///< The rest of the name is held until the value shows whether the member is kept
+
+// Where the member name that has not been written yet is held
+#define HOLD_NONE       0
+#define HOLD_PATH       1   ///< The name is the component of the `held` path
+#define HOLD_BUFFER     2   ///< The name is in the hold buffer
+#define HOLD_WRITTEN    3   ///< The name did not fit into the hold buffer and has been written, so the value is kept
+
+// What is done with an element
+#define ACTION_DROP     0   ///< The element is skipped
+#define ACTION_COPY     1   ///< The entire element is copied
+#define ACTION_MATCH    2   ///< The element is kept, but its members or elements are matched against the paths
+#define ACTION_NONE     0xff
+
+int jspp_filter_init(jspp_filter_t * filter, const char * const * paths, uint8_t mode,
+    char * buffer, uint16_t size, jspp_flush_t sink, void * sink_data)
+{
+    // one more than the limit marks the filter that has too many paths
+    uint8_t num_paths = 0;
+    while (paths[num_paths] && num_paths <= JSPP_FILTER_MAX_PATHS) {
+        ++num_paths;
+    }
+    jspp_writer_init(&filter->writer, buffer, size, sink, sink_data);
+    filter->paths = paths;
+    filter->num_paths = num_paths;
+    filter->mode = mode;
+    filter->started = 0;
+    filter->partial = 0;
+    filter->copy_level = 0;
+    filter->name_state = NAME_NONE;
+    filter->value_action = ACTION_NONE;
+    filter->name_hold = HOLD_NONE;
+    return num_paths > JSPP_FILTER_MAX_PATHS ? -1 : 0;
+}
+
+/**
+ * \brief Finds a path component.
+ *
+ * \param      path   The path
+ * \param      index  Index of the component
+ * \param[out] length A pointer to the variable in which the length of the component will be returned
+ *
+ * \return Pointer to the component or NULL (and zero length) when the path has fewer components
+ */
+static const char * path_component(const char * path, uint8_t index, uint16_t * length)
+{
+    *length = 0;
+    for (; index > 0; index--) {
+        while (*path != '/') {
+            if (*path == '\0') {
+                return NULL;
+            }
+            ++path;
+        }
+        ++path;
+    }
+    const char * end = path;
+    while (*end != '/' && *end != '\0') {
+        ++end;
+    }
+    *length = end - path;
+    return path;
+}
+
+static inline int is_wildcard(const char * component, uint16_t length)
+{
+    return length == 1 && component[0] == '*';
+}
+
+/**
+ * \brief Decides what to do with an element.
+ *
+ * \param      filter     A pointer to the filter struct
+ * \param      mask       Paths that match the path to the element
+ * \param      depth      Index of the path component that has matched the element
+ * \param[out] value_mask A pointer to the variable that receives the paths to match against members and elements of the element
+ *
+ * \return The action
+ */
+static uint8_t decide(const jspp_filter_t * filter, uint32_t mask, uint8_t depth, uint32_t * value_mask)
+{
+    uint16_t length;
+    for (uint8_t i = 0; i < filter->num_paths; i++) {
+        if ((mask & (1u << i)) && !path_component(filter->paths[i], depth + 1, &length)) {
+            // the entire path has matched
+            return filter->mode == JSPP_FILTER_KEEP ? ACTION_COPY : ACTION_DROP;
+        }
+    }
+    *value_mask = mask;
+    if (mask) {
+        return ACTION_MATCH;
+    }
+    return filter->mode == JSPP_FILTER_KEEP ? ACTION_DROP : ACTION_COPY;
+}
+
+///< Copies the current token to the output
+static uint8_t write_token(jspp_filter_t * filter, uint8_t token)
+{
+    uint16_t length;
+    const char * text = jspp_text(&filter->parser, &length);
+    return jspp_write_raw(&filter->writer, token, text, length);
+}
+
+static inline int is_part(uint8_t token)
+{
+    return token == JSON_MEMBER_NAME_PART || token == JSON_STRING_PART || token == JSON_NUMBER_PART;
+}
+
+/**
+ * \brief Appends a part of the member name to the hold buffer.
+ *
+ * \return 0 if the writer has failed
+ *
+ * When the name does not fit, the name held so far and the part are written instead. The rest of the
+ * name is written as it arrives then.
+ */
+static int hold_name(jspp_filter_t * filter, uint8_t token, const char * text, uint16_t length)
+{
+    if (filter->name_hold == HOLD_BUFFER && filter->hold_length + length > JSPP_FILTER_NAME_SIZE) {
+        filter->name_hold = HOLD_WRITTEN;
+        if (jspp_write_raw(&filter->writer, JSON_MEMBER_NAME_PART, filter->hold_buffer, filter->hold_length) != JSON_MEMBER_NAME_PART) {
+            return 0;
+        }
+    }
+    if (filter->name_hold == HOLD_WRITTEN) {
+        return jspp_write_raw(&filter->writer, token, text, length) == token;
+    }
+    for (uint16_t i = 0; i < length; i++) {
+        filter->hold_buffer[filter->hold_length++] = text[i];
+    }
+    return 1;
+}
+
+///< Writes the member name that has been held until its value turned out to be kept
+static uint8_t write_held_name(jspp_filter_t * filter)
+{
+    const char * name = filter->hold_buffer;
+    uint16_t length = filter->hold_length;
+    if (filter->name_hold == HOLD_PATH) {
+        name = path_component(filter->paths[filter->held], filter->writer.level - 1, &length);
+    }
+    filter->name_hold = HOLD_NONE;
+    return jspp_write_raw(&filter->writer, JSON_MEMBER_NAME, name, length);
+}
+
+static uint8_t filter_member_name(jspp_filter_t * filter, uint8_t token)
+{
+    jspp_t * parser = &filter->parser;
+    uint8_t level = filter->writer.level;
+    uint8_t depth = level - 1;
+    uint16_t length;
+    const char * text = jspp_text(parser, &length);
+
+    if (filter->name_state == NAME_WRITING) {
+        if (jspp_write_raw(&filter->writer, token, text, length) != token) {
+            return JSON_TOO_DEEP;
+        }
+        if (token == JSON_MEMBER_NAME) {
+            filter->name_state = NAME_NONE;
+        }
+        return jspp_next(parser);
+    }
+    if (filter->name_state == NAME_HOLDING) {
+        if (!hold_name(filter, token, text, length)) {
+            return JSON_TOO_DEEP;
+        }
+        if (token == JSON_MEMBER_NAME) {
+            filter->name_state = NAME_NONE;
+        }
+        return jspp_next(parser);
+    }
+    if (filter->name_state == NAME_NONE) {
+        filter->name_state = NAME_MATCHING;
+        filter->name_mask = filter->masks[level];
+        filter->name_length = 0;
+    }
+
+    // The name is not kept anywhere while it is being matched. The part of the name that has been
+    // matched so far is equal to the prefix of the component of the `held` path.
+    uint32_t mask = filter->name_mask;
+    uint32_t literals = 0;
+    uint8_t held = filter->held;
+    for (uint8_t i = 0; i < filter->num_paths; i++) {
+        uint32_t bit = 1u << i;
+        if (!(mask & bit)) {
+            continue;
+        }
+        uint16_t component_length;
+        const char * component = path_component(filter->paths[i], depth, &component_length);
+        if (is_wildcard(component, component_length)) {
+            continue;
+        }
+        uint16_t matched = filter->name_length;
+        uint16_t j = 0;
+        if (length <= component_length - matched) {
+            while (j < length && component[matched + j] == text[j]) {
+                ++j;
+            }
+        }
+        if (j == length && (token == JSON_MEMBER_NAME_PART || matched + length == component_length)) {
+            literals |= bit;
+            filter->held = i;
+        } else {
+            mask &= ~bit;
+        }
+    }
+    filter->name_mask = mask;
+    if (literals && token == JSON_MEMBER_NAME_PART) {
+        // the rest of the name will decide
+        filter->name_length += length;
+        return jspp_next(parser);
+    }
+
+    uint32_t value_mask = 0;
+    uint8_t action = decide(filter, mask, depth, &value_mask);
+    if (action == ACTION_DROP) {
+        filter->name_state = NAME_NONE;
+        // skips the rest of the name and the member value
+        return jspp_skip(parser);
+    }
+    filter->value_action = action;
+    filter->value_mask = value_mask;
+    if (action == ACTION_MATCH && filter->mode == JSPP_FILTER_KEEP) {
+        // The member is kept only if its value is an object or an array, so the name is written
+        // once the value is known.
+        filter->name_state = token == JSON_MEMBER_NAME ? NAME_NONE : NAME_HOLDING;
+        if (literals && token == JSON_MEMBER_NAME) {
+            filter->name_hold = HOLD_PATH;
+            return jspp_next(parser);
+        }
+        filter->name_hold = HOLD_BUFFER;
+        filter->hold_length = 0;
+        if (filter->name_length > 0) {
+            uint16_t component_length;
+            const char * component = path_component(filter->paths[held], depth, &component_length);
+            if (!hold_name(filter, JSON_MEMBER_NAME_PART, component, filter->name_length)) {
+                return JSON_TOO_DEEP;
+            }
+        }
+        if (!hold_name(filter, token, text, length)) {
+            return JSON_TOO_DEEP;
+        }
+        return jspp_next(parser);
+    }
+    if (filter->name_length > 0) {
+        uint16_t component_length;
+        const char * component = path_component(filter->paths[held], depth, &component_length);
+        if (jspp_write_raw(&filter->writer, JSON_MEMBER_NAME_PART, component, filter->name_length) != JSON_MEMBER_NAME_PART) {
+            return JSON_TOO_DEEP;
+        }
+    }
+    if (jspp_write_raw(&filter->writer, token, text, length) != token) {
+        return JSON_TOO_DEEP;
+    }
+    filter->name_state = token == JSON_MEMBER_NAME ? NAME_NONE : NAME_WRITING;
+    return jspp_next(parser);
+}
+
+static uint8_t filter_token(jspp_filter_t * filter, uint8_t token)
+{
+    jspp_t * parser = &filter->parser;
+    uint8_t level = filter->writer.level;
+
+    if (filter->partial || (filter->copy_level && level >= filter->copy_level)) {
+        if (write_token(filter, token) != token) {
+            return JSON_TOO_DEEP;
+        }
+        filter->partial = is_part(token);
+        if (filter->copy_level > filter->writer.level) {
+            filter->copy_level = 0;
+        }
+        return jspp_next(parser);
+    }
+
+    uint8_t action;
+    uint32_t mask = 0;
+    switch (token) {
+        case JSON_MEMBER_NAME_PART:
+        case JSON_MEMBER_NAME: {
+            return filter_member_name(filter, token);
+        }
+        case JSON_OBJECT_END:
+        case JSON_ARRAY_END: {
+            if (write_token(filter, token) != token) {
+                return JSON_TOO_DEEP;
+            }
+            return jspp_next(parser);
+        }
+    }
+    if (level == 0) {
+        // the top level element is always kept
+        mask = filter->num_paths < 32 ? (1u << filter->num_paths) - 1 : 0xffffffff;
+        action = mask || filter->mode == JSPP_FILTER_KEEP ? ACTION_MATCH : ACTION_COPY;
+    } else if (filter->value_action != ACTION_NONE) {
+        // member value
+        action = filter->value_action;
+        mask = filter->value_mask;
+        filter->value_action = ACTION_NONE;
+    } else {
+        // array element
+        uint32_t elements = 0;
+        for (uint8_t i = 0; i < filter->num_paths; i++) {
+            if (filter->masks[level] & (1u << i)) {
+                uint16_t length;
+                const char * component = path_component(filter->paths[i], level - 1, &length);
+                if (is_wildcard(component, length)) {
+                    elements |= 1u << i;
+                }
+            }
+        }
+        action = decide(filter, elements, level - 1, &mask);
+    }
+    if (action == ACTION_MATCH && filter->mode == JSPP_FILTER_KEEP && level > 0 && filter->name_hold != HOLD_WRITTEN
+        && token != JSON_OBJECT_BEGIN && token != JSON_ARRAY_BEGIN) {
+        // only a part of the path has matched, and the value has nothing that could match the rest
+        action = ACTION_DROP;
+    }
+    if (action == ACTION_DROP) {
+        filter->name_hold = HOLD_NONE;
+        return jspp_skip(parser);
+    }
+    if (filter->name_hold == HOLD_WRITTEN) {
+        filter->name_hold = HOLD_NONE;
+    } else if (filter->name_hold != HOLD_NONE && write_held_name(filter) != JSON_MEMBER_NAME) {
+        return JSON_TOO_DEEP;
+    }
+    if (write_token(filter, token) != token) {
+        return JSON_TOO_DEEP;
+    }
+    if (token == JSON_OBJECT_BEGIN || token == JSON_ARRAY_BEGIN) {
+        if (action == ACTION_COPY) {
+            filter->copy_level = filter->writer.level;
+        } else {
+            filter->masks[filter->writer.level] = mask;
+        }
+    }
+    filter->partial = is_part(token);
+    return jspp_next(parser);
+}
+
+uint8_t jspp_filter_feed(jspp_filter_t * filter, const char * text, uint16_t text_len)
+{
+    uint8_t token;
+    if (filter->num_paths > JSPP_FILTER_MAX_PATHS) {
+        return JSON_INVALID;
+    }
+    if (!filter->started) {
+        filter->started = 1;
+        token = jspp_start(&filter->parser, text, text_len);
+    } else {
+        token = jspp_continue(&filter->parser, text, text_len);
+    }
+
+    while (token > JSON_CONTINUE) {
+        token = filter_token(filter, token);
+    }
+    if (token == JSON_CONTINUE || token == JSON_END) {
+        jspp_write_flush(&filter->writer);
+    }
+    return token;
+}
@@ -0,0 +1,83 @@
+#ifndef __JSPP_FILTER_H
+#define __JSPP_FILTER_H
+
+#include "jspp.h"
+#include "jspp_writer.h"
+
+#define JSPP_FILTER_MAX_PATHS 32    ///< Maximum number of paths a filter can match
+#define JSPP_FILTER_NAME_SIZE 64    ///< Maximum length of a member name matched by `*` that the keep mode can hold
+
+enum _jspp_filter_modes {
+    JSPP_FILTER_KEEP,   ///< Only the elements that match the paths are kept
+    JSPP_FILTER_DROP    ///< The elements that match the paths are removed
+};
+
+typedef struct _jspp_filter {
+    jspp_t                  parser;
+    jspp_writer_t           writer;
+    const char * const *    paths;
+    uint8_t                 num_paths;
+    uint8_t                 mode;           ///< One of the `_jspp_filter_modes`
+    uint8_t                 started;
+    uint8_t                 partial;        ///< Set while a value that is split between fragments is being copied
+    uint8_t                 copy_level;     ///< Writer level of the object or array that is copied entirely. 0 when there is none.
+    uint8_t                 name_state;     ///< State of the member name matcher
+    uint8_t                 held;           ///< Index of the path which component holds the part of the member name matched so far
+    uint8_t                 value_action;   ///< What to do with the value of the current member
+    uint8_t                 name_hold;      ///< Where the member name that is not written yet is held
+    uint16_t                hold_length;    ///< Length of the member name in the hold buffer
+    uint16_t                name_length;    ///< Length of the member name part matched so far
+    uint32_t                name_mask;      ///< Paths that still match the current member name
+    uint32_t                value_mask;     ///< Paths that match the current member
+    uint32_t                masks[JSON_MAX_STACK]; ///< Paths that match the path to the object or array at each writer level
+    char                    hold_buffer[JSPP_FILTER_NAME_SIZE]; ///< The member name matched by `*` that is held
+} jspp_filter_t;
+
+/**
+ * \brief Prepares the filter to process a JSON document.
+ *
+ * \param filter    A pointer to the filter struct allocated by the caller
+ * \param paths     NULL terminated array of paths
+ * \param mode      `JSPP_FILTER_KEEP` to keep only the elements that match the paths or
+ *                  `JSPP_FILTER_DROP` to remove them
+ * \param buffer    Output buffer
+ * \param size      The size of the output buffer
+ * \param sink      The function that receives the filtered JSON text
+ * \param sink_data The pointer that is passed to the `sink` callback
+ *
+ * Path is a list of member names separated by `/`, e.g. `"results/geometry/location"`. A `*` in place
+ * of a name matches any member name or any array element. Names are compared to member names as they
+ * appear in JSON (escape sequences are not decoded). The paths are not copied, so they must stay
+ * available until the filter is done.
+ *
+ * In the keep mode the objects and arrays that are on the path to the kept element are kept as well,
+ * but they only retain the members and elements that match the paths. Other values on the path are
+ * dropped as they cannot contain the kept element. As the type of the value is not known until after
+ * the member name, the name is held until then. A name that matches a `*` is copied into the filter
+ * for that. If it is longer than `JSPP_FILTER_NAME_SIZE` it is written right away and the member is
+ * kept even if its value is not an object or an array.
+ *
+ * \return 0 on success or -1 if there are more than `JSPP_FILTER_MAX_PATHS` paths. The filter does not
+ *         process JSON then - `jspp_filter_feed` returns `JSON_INVALID`.
+ */
+int jspp_filter_init(jspp_filter_t * filter, const char * const * paths, uint8_t mode,
+    char * buffer, uint16_t size, jspp_flush_t sink, void * sink_data);
+
+/**
+ * \brief Filters the next JSON fragment.
+ *
+ * \param filter   A pointer to the filter struct
+ * \param text     The next JSON text fragment
+ * \param text_len The length of the text
+ *
+ * \return `JSON_CONTINUE` when the next fragment is needed, `JSON_END` when the entire JSON has been
+ *         processed, or `JSON_INVALID`/`JSON_TOO_DEEP` when the JSON cannot be parsed (or the filter
+ *         has too many paths).
+ *
+ * The filter copies the text of the kept tokens straight from the input fragments and passes it
+ * to the sink without whitespace. Strings and numbers are not decoded. The output that has been
+ * produced is passed to the sink at the end of each fragment.
+ */
+uint8_t jspp_filter_feed(jspp_filter_t * filter, const char * text, uint16_t text_len);
+
+#endif
@@ -0,0 +1,187 @@
+#include "jspp_index.h"
+#include <stddef.h>
+
+#define NO_MATCH 0xffff ///< `name_length` of the path that does not match the current member name
+
+/**
+ * \brief Finds a path component.
+ *
+ * \param      path   The path
+ * \param      index  Index of the component
+ * \param[out] length A pointer to the variable in which the length of the component will be returned
+ *
+ * \return Pointer to the component
+ */
+static const char * path_component(const char * path, uint8_t index, uint16_t * length)
+{
+    for (; index > 0; index--) {
+        while (*path != '/') {
+            ++path;
+        }
+        ++path;
+    }
+    const char * end = path;
+    while (*end != '/' && *end != '\0') {
+        ++end;
+    }
+    *length = end - path;
+    return path;
+}
+
+static uint8_t count_components(const char * path)
+{
+    if (*path == '\0') {
+        return 0;
+    }
+    uint8_t count = 1;
+    for (; *path; path++) {
+        if (*path == '/') {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static void add_entry(jspp_index_t * index, uint8_t path, uint64_t element)
+{
+    uint8_t checkpoint[JSPP_CHECKPOINT_SIZE];
+    uint16_t size = jspp_checkpoint(&index->parser, checkpoint, sizeof(checkpoint));
+    if (size > 0) {
+        index->callback(path, element, checkpoint, size, index->callback_data);
+    }
+}
+
+void jspp_index_init(jspp_index_t * index, const char * const * paths, uint32_t interval,
+    jspp_index_cb_t callback, void * callback_data)
+{
+    uint8_t num_paths = 0;
+    index->value_mask = 0;
+    while (paths[num_paths] && num_paths < JSPP_INDEX_MAX_PATHS) {
+        index->components[num_paths] = count_components(paths[num_paths]);
+        index->matched[num_paths] = 0;
+        index->array_depth[num_paths] = 0;
+        if (index->components[num_paths] == 0) {
+            // the top level element
+            index->value_mask |= 1u << num_paths;
+        }
+        ++num_paths;
+    }
+    index->paths = paths;
+    index->num_paths = num_paths;
+    index->started = 0;
+    index->depth = 0;
+    index->in_name = 0;
+    index->interval = interval > 0 ? interval : 1;
+    index->callback = callback;
+    index->callback_data = callback_data;
+}
+
+/**
+ * \brief Matches the member name (or its part) against the paths.
+ *
+ * The name is not kept anywhere. Each path remembers how much of the name has matched its component
+ * so far.
+ */
+static void match_member_name(jspp_index_t * index, uint8_t token)
+{
+    uint8_t depth = index->depth;
+    uint16_t length;
+    const char * text = jspp_text(&index->parser, &length);
+
+    if (!index->in_name) {
+        index->in_name = 1;
+        for (uint8_t i = 0; i < index->num_paths; i++) {
+            if (index->matched[i] >= depth) {
+                // the previous member of this object has ended
+                index->matched[i] = depth - 1;
+            }
+            index->name_length[i] = index->matched[i] == depth - 1 && index->matched[i] < index->components[i] ? 0 : NO_MATCH;
+        }
+    }
+    for (uint8_t i = 0; i < index->num_paths; i++) {
+        uint16_t matched = index->name_length[i];
+        if (matched == NO_MATCH) {
+            continue;
+        }
+        uint16_t component_length;
+        const char * component = path_component(index->paths[i], depth - 1, &component_length);
+        uint16_t j = 0;
+        if (length <= component_length - matched) {
+            while (j < length && component[matched + j] == text[j]) {
+                ++j;
+            }
+        }
+        index->name_length[i] = j == length ? matched + length : NO_MATCH;
+        if (token == JSON_MEMBER_NAME && index->name_length[i] == component_length) {
+            index->matched[i] = depth;
+            if (depth == index->components[i]) {
+                index->value_mask |= 1u << i;
+                add_entry(index, i, JSPP_INDEX_VALUE);
+            }
+        }
+    }
+    if (token == JSON_MEMBER_NAME) {
+        index->in_name = 0;
+    }
+}
+
+static void index_token(jspp_index_t * index, uint8_t token)
+{
+    if (token == JSON_MEMBER_NAME_PART || token == JSON_MEMBER_NAME) {
+        match_member_name(index, token);
+        return;
+    }
+    uint32_t value_mask = index->value_mask;
+    index->value_mask = 0;
+    if (token == JSON_STRING_PART || token == JSON_NUMBER_PART) {
+        return;
+    }
+    if (token == JSON_OBJECT_BEGIN || token == JSON_ARRAY_BEGIN) {
+        ++index->depth;
+        if (token == JSON_ARRAY_BEGIN) {
+            for (uint8_t i = 0; i < index->num_paths; i++) {
+                if (value_mask & (1u << i)) {
+                    index->array_depth[i] = index->depth;
+                    index->elements[i] = 0;
+                    add_entry(index, i, 0);
+                }
+            }
+        }
+        return;
+    }
+    if (token == JSON_OBJECT_END || token == JSON_ARRAY_END) {
+        uint8_t depth = --index->depth;
+        for (uint8_t i = 0; i < index->num_paths; i++) {
+            if (index->array_depth[i] > depth) {
+                index->array_depth[i] = 0;
+            }
+            if (index->matched[i] > depth) {
+                index->matched[i] = depth;
+            }
+        }
+    }
+    // an element has ended
+    for (uint8_t i = 0; i < index->num_paths; i++) {
+        if (index->array_depth[i] != 0 && index->array_depth[i] == index->depth) {
+            if (++index->elements[i] % index->interval == 0) {
+                add_entry(index, i, index->elements[i]);
+            }
+        }
+    }
+}
+
+uint8_t jspp_index_feed(jspp_index_t * index, const char * text, uint16_t text_len)
+{
+    uint8_t token;
+    if (!index->started) {
+        index->started = 1;
+        token = jspp_start(&index->parser, text, text_len);
+    } else {
+        token = jspp_continue(&index->parser, text, text_len);
+    }
+    while (token > JSON_CONTINUE) {
+        index_token(index, token);
+        token = jspp_next(&index->parser);
+    }
+    return token;
+}
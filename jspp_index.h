@@ -0,0 +1,75 @@
+#ifndef __JSPP_INDEX_H
+#define __JSPP_INDEX_H
+
+#include "jspp.h"
+
+#define JSPP_INDEX_MAX_PATHS 8 ///< Maximum number of paths an index can have
+
+#define JSPP_INDEX_VALUE ((uint64_t) -1) ///< Element number of the entry that points to the value at the path itself
+
+/**
+ * \brief Receives index entries.
+ *
+ * \param path          Index of the path in the `paths` array
+ * \param element       Index of the array element the checkpoint precedes or `JSPP_INDEX_VALUE`
+ * \param checkpoint    The parser state saved by `jspp_checkpoint`
+ * \param size          The size of the saved state
+ * \param cb_data       The pointer that was passed to `jspp_index_init`
+ */
+typedef void (*jspp_index_cb_t)(uint8_t path, uint64_t element, const uint8_t * checkpoint, uint16_t size, void * cb_data);
+
+typedef struct _jspp_index {
+    jspp_t                  parser;
+    const char * const *    paths;
+    uint8_t                 num_paths;
+    uint8_t                 started;
+    uint8_t                 depth;          ///< Number of objects and arrays that enclose the current token
+    uint8_t                 in_name;        ///< Set while the parts of a split member name are matched
+    uint32_t                interval;       ///< Array elements between the checkpoints
+    uint32_t                value_mask;     ///< Paths that point to the value that follows
+    uint8_t                 components[JSPP_INDEX_MAX_PATHS];   ///< Number of member names in each path
+    uint8_t                 matched[JSPP_INDEX_MAX_PATHS];      ///< Number of path member names that match the names on the way to the current token
+    uint8_t                 array_depth[JSPP_INDEX_MAX_PATHS];  ///< Depth of the elements of the array at the path. 0 when it is not being parsed.
+    uint16_t                name_length[JSPP_INDEX_MAX_PATHS];  ///< Length of the current member name part that has matched the path so far
+    uint64_t                elements[JSPP_INDEX_MAX_PATHS];     ///< Number of the array elements that have been parsed
+    jspp_index_cb_t         callback;
+    void *                  callback_data;
+} jspp_index_t;
+
+/**
+ * \brief Prepares the indexer to process a JSON document.
+ *
+ * \param index         A pointer to the indexer struct allocated by the caller
+ * \param paths         NULL terminated array of paths
+ * \param interval      Number of array elements between the checkpoints
+ * \param callback      The function that receives the index entries
+ * \param callback_data The pointer that is passed to the callback
+ *
+ * A path is a list of member names separated by `/`, e.g. `"export/records"`, like the paths of
+ * `jspp_filter_init`, except that wildcards are not supported. An empty path points to the top level
+ * element. Names are compared to member names as they appear in JSON. The paths are not copied, so
+ * they must stay available until the indexer is done.
+ *
+ * For every member at the path the indexer saves the parser state right before the member value.
+ * When the value is an array it also saves the state before every `interval`-th element, starting
+ * with the first one. Each saved state is passed to the callback together with the path index and
+ * the element index. The application can store them (for example in a sidecar file next to the JSON)
+ * and later resume parsing from the nearest checkpoint with `jspp_restore` and `jspp_seek_index`
+ * instead of parsing the document from the beginning.
+ */
+void jspp_index_init(jspp_index_t * index, const char * const * paths, uint32_t interval,
+    jspp_index_cb_t callback, void * callback_data);
+
+/**
+ * \brief Indexes the next JSON fragment.
+ *
+ * \param index    A pointer to the indexer struct
+ * \param text     The next JSON text fragment
+ * \param text_len The length of the text
+ *
+ * \return `JSON_CONTINUE` when the next fragment is needed, `JSON_END` when the entire JSON has been
+ *         processed, or `JSON_INVALID`/`JSON_TOO_DEEP` when the JSON cannot be parsed.
+ */
+uint8_t jspp_index_feed(jspp_index_t * index, const char * text, uint16_t text_len);
+
+#endif
@@ -0,0 +1,101 @@
+#include "jspp_pipeline.h"
+#include <stddef.h>
+
+static void ring_init(jspp_ring_t * ring)
+{
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+}
+
+///< Puts the buffer into the ring. The ring never overflows as it can hold all the buffers.
+static void ring_put(jspp_ring_t * ring, char * data, uint16_t size)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t index = tail % JSPP_PIPELINE_MAX_BUFFERS;
+    ring->data[index] = data;
+    ring->size[index] = size;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+///< Takes the buffer from the ring. Returns NULL if the ring is empty.
+static char * ring_take(jspp_ring_t * ring, uint16_t * size)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head == atomic_load_explicit(&ring->tail, memory_order_acquire)) {
+        return NULL;
+    }
+    uint32_t index = head % JSPP_PIPELINE_MAX_BUFFERS;
+    char * data = ring->data[index];
+    *size = ring->size[index];
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return data;
+}
+
+void jspp_pipeline_init(jspp_pipeline_t * pipeline, char * buffers, uint8_t num_buffers, uint16_t buffer_size)
+{
+    ring_init(&pipeline->filled);
+    ring_init(&pipeline->free);
+    if (num_buffers > JSPP_PIPELINE_MAX_BUFFERS) {
+        num_buffers = JSPP_PIPELINE_MAX_BUFFERS;
+    }
+    for (uint8_t i = 0; i < num_buffers; i++) {
+        ring_put(&pipeline->free, buffers + i * buffer_size, buffer_size);
+    }
+    pipeline->current = NULL;
+    pipeline->buffer_size = buffer_size;
+    pipeline->started = 0;
+    pipeline->waiting = 1;
+    pipeline->closed = 0;
+}
+
+char * jspp_pipeline_acquire(jspp_pipeline_t * pipeline)
+{
+    uint16_t size;
+    return ring_take(&pipeline->free, &size);
+}
+
+void jspp_pipeline_publish(jspp_pipeline_t * pipeline, char * buffer, uint16_t size)
+{
+    ring_put(&pipeline->filled, buffer, size);
+}
+
+uint8_t jspp_pipeline_resume(jspp_pipeline_t * pipeline, uint8_t token)
+{
+    while (token == JSON_CONTINUE) {
+        if (pipeline->closed) {
+            return JSON_INVALID;
+        }
+        if (pipeline->current) {
+            // the parser does not reference the fragment anymore
+            ring_put(&pipeline->free, pipeline->current, pipeline->buffer_size);
+            pipeline->current = NULL;
+        }
+        pipeline->waiting = 1;
+
+        uint16_t size;
+        char * data = ring_take(&pipeline->filled, &size);
+        if (!data) {
+            return JSON_CONTINUE;
+        }
+        if (size == 0) {
+            // the stream has ended before JSON did
+            ring_put(&pipeline->free, data, pipeline->buffer_size);
+            pipeline->closed = 1;
+            return JSON_INVALID;
+        }
+        pipeline->current = data;
+        pipeline->waiting = 0;
+        if (!pipeline->started) {
+            pipeline->started = 1;
+            token = jspp_start(&pipeline->parser, data, size);
+        } else {
+            token = jspp_continue(&pipeline->parser, data, size);
+        }
+    }
+    return token;
+}
+
+uint8_t jspp_pipeline_next(jspp_pipeline_t * pipeline)
+{
+    return jspp_pipeline_resume(pipeline, pipeline->waiting ? JSON_CONTINUE : jspp_next(&pipeline->parser));
+}
@@ -0,0 +1,96 @@
+#ifndef __JSPP_PIPELINE_H
+#define __JSPP_PIPELINE_H
+
+#include "jspp.h"
+#include <stdatomic.h>
+
+#define JSPP_PIPELINE_MAX_BUFFERS   16
+#define JSPP_CACHE_LINE_SIZE        64
+
+/// Lock-free single-producer/single-consumer ring of fragment buffers
+typedef struct _jspp_ring {
+    _Atomic uint32_t    head;   ///< Position of the next buffer to take. Written by the consumer.
+    char                head_pad[JSPP_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    _Atomic uint32_t    tail;   ///< Position of the next buffer to put. Written by the producer.
+    char                tail_pad[JSPP_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    char *              data[JSPP_PIPELINE_MAX_BUFFERS];
+    uint16_t            size[JSPP_PIPELINE_MAX_BUFFERS];
+} jspp_ring_t;
+
+typedef struct _jspp_pipeline {
+    jspp_ring_t     filled;         ///< Fragments from the reader to the parser
+    jspp_ring_t     free;           ///< Buffers from the parser back to the reader
+    jspp_t          parser;
+    char *          current;        ///< The fragment the parser is working on
+    uint16_t        buffer_size;
+    uint8_t         started;
+    uint8_t         waiting;        ///< Set when the parser waits for the next fragment
+    uint8_t         closed;         ///< Set when the reader has ended the stream
+} jspp_pipeline_t;
+
+/**
+ * \brief Initializes the pipeline.
+ *
+ * \param pipeline    A pointer to the pipeline struct allocated by the caller
+ * \param buffers     Memory for the fragment buffers - `num_buffers * buffer_size` bytes
+ * \param num_buffers Number of buffers (up to `JSPP_PIPELINE_MAX_BUFFERS`)
+ * \param buffer_size The size of each buffer
+ *
+ * The pipeline connects two threads - the reader that receives JSON fragments and the parser
+ * that processes them. The reader takes free buffers with `jspp_pipeline_acquire`, fills them
+ * and passes them to the parser with `jspp_pipeline_publish`. The parser takes tokens with
+ * `jspp_pipeline_next`, which moves to the next fragment and returns the old one to the reader
+ * when the parser reaches the end of it. Neither side ever blocks - when a buffer or a fragment is
+ * not available the functions return immediately and the caller decides how to wait.
+ */
+void jspp_pipeline_init(jspp_pipeline_t * pipeline, char * buffers, uint8_t num_buffers, uint16_t buffer_size);
+
+/**
+ * \brief Takes a free buffer. Called by the reader.
+ *
+ * \param pipeline A pointer to the pipeline struct
+ *
+ * \return Pointer to the buffer of `buffer_size` bytes or NULL when all the buffers are in use.
+ */
+char * jspp_pipeline_acquire(jspp_pipeline_t * pipeline);
+
+/**
+ * \brief Passes the filled buffer to the parser. Called by the reader.
+ *
+ * \param pipeline A pointer to the pipeline struct
+ * \param buffer   The buffer returned by `jspp_pipeline_acquire`
+ * \param size     Size of the data in the buffer. 0 ends the stream.
+ */
+void jspp_pipeline_publish(jspp_pipeline_t * pipeline, char * buffer, uint16_t size);
+
+/**
+ * \brief Returns the next token. Called by the parser.
+ *
+ * \param pipeline A pointer to the pipeline struct
+ *
+ * \return The token ID. `JSON_CONTINUE` means that the next fragment has not been published yet and
+ *         the function should be called again later. `JSON_INVALID` is also returned when the reader
+ *         ends the stream before the end of JSON.
+ *
+ * Fragment lifetime: the text returned by `jspp_text` points into the current fragment buffer. The
+ * buffer is returned to the reader only inside `jspp_pipeline_next` (or `jspp_pipeline_resume`),
+ * after the parser has reached the end of it. Thus the token text stays valid until the next call
+ * to either of these functions.
+ */
+uint8_t jspp_pipeline_next(jspp_pipeline_t * pipeline);
+
+/**
+ * \brief Continues with the result of a parser function. Called by the parser.
+ *
+ * \param pipeline A pointer to the pipeline struct
+ * \param token    The token returned by a function that was called directly on the `parser`,
+ *                 like `jspp_skip` or `jspp_find_member`
+ *
+ * \return The token ID (see `jspp_pipeline_next`)
+ *
+ * When the function returned `JSON_CONTINUE` the pipeline moves to the next fragment and lets the
+ * parser finish the operation there.
+ */
+uint8_t jspp_pipeline_resume(jspp_pipeline_t * pipeline, uint8_t token);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef __JSPP_PROBES_H
+#define __JSPP_PROBES_H
+
+// Static tracing probes. They are compiled only when the library is built with `-DJSPP_USDT`, which
+// needs <sys/sdt.h> (systemtap-sdt-dev or systemtap-sdt-devel package). Each enabled probe is a
+// single `nop` instruction until a tracer (bpftrace, perf, SystemTap) attaches to it, so the probes
+// can stay in production builds. Otherwise they are not compiled at all.
+//
+// Provider `jspp`:
+// - start(text_len)                         - `jspp_start` is called
+// - continue__entry(text_len, offset, level) - `jspp_continue` is called. `offset` is the absolute offset of the fragment.
+// - continue__return(token, level)           - `jspp_continue` returns
+// - token(token, level, token_len)           - the scanner has reached the end of a token or of the fragment
+// - skip__begin(level, offset)               - `jspp_skip` or `jspp_skip_next` starts skipping at the absolute `offset`
+// - skip__end(level, offset)                 - the skipped element ends at the absolute `offset`
+// - error(token, level, offset)              - JSON is rejected with `JSON_INVALID` or `JSON_TOO_DEEP` at the absolute `offset`
+
+#ifdef JSPP_USDT
+#include <sys/sdt.h>
+#define JSPP_PROBE1(name, a)        DTRACE_PROBE1(jspp, name, a)
+#define JSPP_PROBE2(name, a, b)     DTRACE_PROBE2(jspp, name, a, b)
+#define JSPP_PROBE3(name, a, b, c)  DTRACE_PROBE3(jspp, name, a, b, c)
+#else
+#define JSPP_PROBE1(name, a)        do {} while (0)
+#define JSPP_PROBE2(name, a, b)     do {} while (0)
+#define JSPP_PROBE3(name, a, b, c)  do {} while (0)
+#endif
+
+#endif
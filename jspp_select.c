@@ -0,0 +1,263 @@
+#include "jspp_select.h"
+#include "jspp_swar.h"
+#include <stddef.h>
+
+// Parts of the record that are checked by the confirming parser
+enum _select_states {
+    EXPECTING_RECORD,
+    EXPECTING_NAME,
+    EXPECTING_VALUE
+};
+
+static uint16_t string_length(const char * str)
+{
+    uint16_t length = 0;
+    while (str[length]) {
+        ++length;
+    }
+    return length;
+}
+
+static int equal(const char * a, const char * b, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        if (a[i] != b[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/// Returns the pointer to the first line feed in the text or `end` if there is none
+static const char * find_line_feed(const char * text, const char * end)
+{
+    for (; text + SWAR_SIZE <= end; text += SWAR_SIZE) {
+        swar_t mask = swar_equal(swar_load(text), '\n');
+        if (mask) {
+            return text + swar_first(mask);
+        }
+    }
+    while (text < end && *text != '\n') {
+        ++text;
+    }
+    return text;
+}
+
+/// Returns the pointer to the start of the line `text` is in without looking before `start`
+static const char * find_line_start(const char * start, const char * text)
+{
+    while (text > start && text[-1] != '\n') {
+        --text;
+    }
+    return text;
+}
+
+/**
+ * \brief Finds the first occurrence of the needle in the text.
+ *
+ * The first and the last bytes of the needle are compared with a word of the text at once, so every
+ * candidate position is tested in a few instructions and the rest of the needle is compared only at
+ * the positions where both bytes match.
+ *
+ * \return Pointer to the found needle or NULL
+ */
+static const char * find(const char * text, const char * end, const char * needle, uint16_t length)
+{
+    if (length == 0 || end - text < length) {
+        return NULL;
+    }
+    const char * const last = end - length;
+    const uint8_t head = needle[0];
+    const uint8_t tail = needle[length - 1];
+    for (; text + SWAR_SIZE - 1 <= last; text += SWAR_SIZE) {
+        swar_t mask = swar_equal(swar_load(text), head) & swar_equal(swar_load(text + length - 1), tail);
+        while (mask) {
+            // marks are not exact, so the first and the last bytes are compared again
+            const char * candidate = text + swar_first(mask);
+            if (equal(candidate, needle, length)) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+    for (; text <= last; text++) {
+        if (*text == needle[0] && equal(text, needle, length)) {
+            return text;
+        }
+    }
+    return NULL;
+}
+
+static uint16_t fragment_size(const char * text, const char * end)
+{
+    return end - text > 0xffff ? 0xffff : end - text;
+}
+
+/// Returns the index of the predicate that names the member or -1 if there is none
+static int match_name(jspp_select_t * select, const char * name, uint32_t length)
+{
+    for (uint8_t i = 0; i < select->num_predicates; i++) {
+        if (select->name_length[i] == length && equal(name, select->predicates[i].name, length)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * \brief Parses the candidate record to confirm that the predicates match its members.
+ *
+ * Values of the members the predicates do not name are skipped. The text of a split name or value
+ * starts where its first part starts, as the entire record is in memory.
+ */
+static int confirm(jspp_select_t * select, const char * record, const char * end)
+{
+    static const char * const literals[] = { "null", "true", "false" };
+    jspp_t * parser = &select->parser;
+    const uint32_t all = (1u << select->num_predicates) - 1;
+    uint32_t matched = 0;
+    uint8_t state = EXPECTING_RECORD;
+    int member = -1;
+    const char * start = NULL;
+
+    ++select->candidates;
+    uint8_t token = jspp_start(parser, record, fragment_size(record, end));
+    const char * next = record + parser->text_length;
+    for (;;) {
+        if (token == JSON_CONTINUE) {
+            if (next == end) {
+                return 0;
+            }
+            uint16_t size = fragment_size(next, end);
+            token = jspp_continue(parser, next, size);
+            next += size;
+            continue;
+        }
+        uint16_t length;
+        const char * text = jspp_text(parser, &length);
+        if (!start) {
+            start = text;
+        }
+        if (token == JSON_MEMBER_NAME_PART || token == JSON_STRING_PART || token == JSON_NUMBER_PART) {
+            token = jspp_next(parser);
+            continue;
+        }
+        const char * stop = text + length;
+
+        switch (state) {
+            case EXPECTING_RECORD: {
+                if (token != JSON_OBJECT_BEGIN) {
+                    return 0;
+                }
+                if (matched == all) {
+                    // there are no predicates
+                    return 1;
+                }
+                state = EXPECTING_NAME;
+                token = jspp_next(parser);
+                break;
+            }
+            case EXPECTING_NAME: {
+                if (token != JSON_MEMBER_NAME) {
+                    // the end of the record (or invalid JSON) before all predicates have matched
+                    return 0;
+                }
+                member = match_name(select, start, stop - start);
+                if (member < 0 || (matched & (1u << member))) {
+                    token = jspp_skip(parser);
+                } else {
+                    state = EXPECTING_VALUE;
+                    token = jspp_next(parser);
+                }
+                break;
+            }
+            case EXPECTING_VALUE: {
+                if (token == JSON_STRING) {
+                    // the value of the predicate includes quotes
+                    --start;
+                    ++stop;
+                } else if (JSON_NULL <= token && token <= JSON_FALSE) {
+                    // only the last part of a split literal is reported
+                    start = literals[token - JSON_NULL];
+                    stop = start + string_length(start);
+                } else if (token < JSON_INTEGER || JSON_STRING < token) {
+                    // objects and arrays never match, and invalid JSON is not selected
+                    return 0;
+                }
+                if (stop - start != select->value_length[member]
+                    || !equal(start, select->predicates[member].value, stop - start)) {
+                    return 0;
+                }
+                matched |= 1u << member;
+                if (matched == all) {
+                    return 1;
+                }
+                state = EXPECTING_NAME;
+                token = jspp_next(parser);
+                break;
+            }
+        }
+        start = NULL;
+    }
+}
+
+/// Checks whether the values of all predicates (but the one that has been found already) are in the record
+static int prefilter(jspp_select_t * select, const char * record, const char * end)
+{
+    for (uint8_t i = 0; i < select->num_predicates; i++) {
+        if (i != select->scan && !find(record, end, select->predicates[i].value, select->value_length[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void jspp_select_init(jspp_select_t * select, const jspp_predicate_t * predicates, uint8_t num_predicates,
+    jspp_select_cb_t callback, void * callback_data)
+{
+    if (num_predicates > JSPP_SELECT_MAX_PREDICATES) {
+        num_predicates = JSPP_SELECT_MAX_PREDICATES;
+    }
+    select->predicates = predicates;
+    select->num_predicates = num_predicates;
+    select->scan = 0;
+    for (uint8_t i = 0; i < num_predicates; i++) {
+        select->name_length[i] = string_length(predicates[i].name);
+        select->value_length[i] = string_length(predicates[i].value);
+        // the longest value is the least likely to be found by chance
+        if (select->value_length[i] > select->value_length[select->scan]) {
+            select->scan = i;
+        }
+    }
+    select->candidates = 0;
+    select->selected = 0;
+    select->callback = callback;
+    select->callback_data = callback_data;
+}
+
+uint32_t jspp_select_records(jspp_select_t * select, const char * text, uint32_t text_len, uint8_t last)
+{
+    const char * const end = text + text_len;
+    // the end of the complete records
+    const char * const complete = last ? end : find_line_start(text, end);
+    const char * next = text;
+    while (next < complete) {
+        const char * found = next;
+        if (select->num_predicates > 0) {
+            // records before the one with the value are skipped without looking for their ends
+            const jspp_predicate_t * predicate = &select->predicates[select->scan];
+            found = find(next, complete, predicate->value, select->value_length[select->scan]);
+            if (!found) {
+                break;
+            }
+        }
+        const char * record = find_line_start(next, found);
+        const char * record_end = find_line_feed(found, complete);
+        if (prefilter(select, record, record_end) && confirm(select, record, record_end)) {
+            ++select->selected;
+            select->callback(record, record_end - record, select->callback_data);
+        }
+        next = record_end < complete ? record_end + 1 : complete;
+    }
+    return complete - text;
+}
@@ -0,0 +1,75 @@
+#ifndef __JSPP_SELECT_H
+#define __JSPP_SELECT_H
+
+#include "jspp.h"
+
+#define JSPP_SELECT_MAX_PREDICATES 8 ///< Maximum number of predicates a selector can have
+
+/// Matches the top level member `name` that has the `value`
+typedef struct _jspp_predicate {
+    const char *    name;   ///< Member name as it appears in JSON, without quotes
+    const char *    value;  ///< Member value as it appears in JSON, e.g. `"error"` (with quotes), `404` or `true`
+} jspp_predicate_t;
+
+/**
+ * \brief Receives the selected records.
+ *
+ * \param record    The text of the record (without the line feed)
+ * \param length    The length of the record
+ * \param cb_data   The pointer that was passed to `jspp_select_init`
+ */
+typedef void (*jspp_select_cb_t)(const char * record, uint32_t length, void * cb_data);
+
+typedef struct _jspp_select {
+    jspp_t                      parser;
+    const jspp_predicate_t *    predicates;
+    uint8_t                     num_predicates;
+    uint8_t                     scan;           ///< The predicate which value is searched for in the raw text
+    uint16_t                    name_length[JSPP_SELECT_MAX_PREDICATES];
+    uint16_t                    value_length[JSPP_SELECT_MAX_PREDICATES];
+    uint64_t                    candidates;     ///< Number of records that have passed the prefilter and have been parsed
+    uint64_t                    selected;       ///< Number of records that have been passed to the callback
+    jspp_select_cb_t            callback;
+    void *                      callback_data;
+} jspp_select_t;
+
+/**
+ * \brief Prepares the selector to process newline delimited JSON records.
+ *
+ * \param select            A pointer to the selector struct allocated by the caller
+ * \param predicates        The array of predicates
+ * \param num_predicates    The number of predicates (at most `JSPP_SELECT_MAX_PREDICATES`)
+ * \param callback          The function that receives the selected records
+ * \param callback_data     The pointer that is passed to the callback
+ *
+ * A record is selected when it is an object and all predicates match its top level members. Names
+ * and values are compared to the member names and values as they appear in JSON, i.e. escapes are
+ * not decoded and numbers are compared as text. Only scalar values - strings, numbers, `true`, `false`
+ * and `null` - can be matched. The predicates are not copied, so they must stay available until the
+ * selector is done.
+ */
+void jspp_select_init(jspp_select_t * select, const jspp_predicate_t * predicates, uint8_t num_predicates,
+    jspp_select_cb_t callback, void * callback_data);
+
+/**
+ * \brief Selects the matching records from the buffer.
+ *
+ * \param select    A pointer to the selector struct
+ * \param text      The records, separated by line feeds
+ * \param text_len  The length of the text
+ * \param last      Set when the text ends the stream, i.e. when the last record does not need a line feed
+ *
+ * \return The number of processed bytes, i.e. the length of the complete records at the start of
+ *         the text. The rest - an incomplete record - has to be passed again, with more data appended
+ *         to it, in the next call.
+ *
+ * Records are not parsed one by one. Instead the raw text is searched for the value of the longest
+ * predicate, and the records that do not contain it are skipped without even looking for their ends.
+ * A record that contains it (and the other values) is a candidate that is parsed to confirm that the
+ * values do belong to the members the predicates name. Thus the selector spends most of its time in
+ * the substring search and the parser is only used for a fraction of the records on selective queries.
+ * Once all predicates have matched the rest of the record is not validated.
+ */
+uint32_t jspp_select_records(jspp_select_t * select, const char * text, uint32_t text_len, uint8_t last);
+
+#endif
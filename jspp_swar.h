@@ -0,0 +1,148 @@
+#ifndef __JSPP_SWAR_H
+#define __JSPP_SWAR_H
+
+// Word-at-a-time ("SIMD within a register") helpers that are shared by jspp modules.
+// Words are always loaded in the little-endian order, so the first byte of the text
+// is the lowest byte of the word on any target.
+
+#include <stdint.h>
+
+#if UINTPTR_MAX > 0xffffffff
+typedef uint64_t swar_t;
+#else
+typedef uint32_t swar_t;
+#endif
+
+#define SWAR_SIZE       sizeof(swar_t)
+#define SWAR_ONES       ((swar_t) -1 / 0xff)
+#define SWAR_HIGHS      (SWAR_ONES * 0x80)
+#define SWAR_REPEAT(c)  (SWAR_ONES * (uint8_t) (c))
+
+///< Loads a word from the (possibly unaligned) text
+static inline swar_t swar_load(const char * ptr)
+{
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    swar_t word;
+    __builtin_memcpy(&word, ptr, sizeof(word));
+    return word;
+#else
+    swar_t word = 0;
+    for (unsigned i = 0; i < SWAR_SIZE; i++) {
+        word |= (swar_t) (uint8_t) ptr[i] << (i * 8);
+    }
+    return word;
+#endif
+}
+
+///< Loads 4 bytes from the (possibly unaligned) text
+static inline uint32_t swar_load32(const char * ptr)
+{
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint32_t word;
+    __builtin_memcpy(&word, ptr, sizeof(word));
+    return word;
+#else
+    return (uint32_t) (uint8_t) ptr[0]
+        | (uint32_t) (uint8_t) ptr[1] << 8
+        | (uint32_t) (uint8_t) ptr[2] << 16
+        | (uint32_t) (uint8_t) ptr[3] << 24;
+#endif
+}
+
+///< Loads 8 bytes from the (possibly unaligned) text
+static inline uint64_t swar_load64(const char * ptr)
+{
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t word;
+    __builtin_memcpy(&word, ptr, sizeof(word));
+    return word;
+#else
+    return (uint64_t) swar_load32(ptr) | (uint64_t) swar_load32(ptr + 4) << 32;
+#endif
+}
+
+///< Returns the number of ASCII digits the word, loaded by `swar_load64`, starts with
+static inline unsigned swar_leading_digits(uint64_t word)
+{
+    // digits become 0..9, and the bytes that are at least 10 are marked exactly
+    uint64_t digits = word ^ 0x3030303030303030;
+    uint64_t mask = (((digits & 0x7f7f7f7f7f7f7f7f) + 0x7676767676767676) | digits) & 0x8080808080808080;
+    if (!mask) {
+        return 8;
+    }
+#if defined(__GNUC__)
+    return __builtin_ctzll(mask) / 8;
+#else
+    unsigned i = 0;
+    while (!(mask & 0x80)) {
+        mask >>= 8;
+        ++i;
+    }
+    return i;
+#endif
+}
+
+///< Converts the first `count` (1 to 8) ASCII digits of the word, loaded by `swar_load64`, into their value
+static inline uint32_t swar_digits_value(uint64_t word, unsigned count)
+{
+    // the digits are moved to the top of the word, so the bytes that are shifted in become leading zeros
+    word <<= 8 * (8 - count);
+    // pairs of digits, then groups of 4, then all 8 are combined by multiplying by the "scale and add" constants
+    word = (word & 0x0f0f0f0f0f0f0f0f) * (1 + (10 << 8)) >> 8;
+    word = (word & 0x00ff00ff00ff00ff) * (1 + (100 << 16)) >> 16;
+    return (uint32_t) ((word & 0x0000ffff0000ffff) * (1 + (10000ull << 32)) >> 32);
+}
+
+// The functions below set the high bit of every byte of the word that matches the condition.
+// Note that bytes after the first match might be marked even though they do not match - only
+// the first marked byte is reliable.
+
+///< Marks zero bytes
+static inline swar_t swar_zero(swar_t word)
+{
+    return (word - SWAR_ONES) & ~word & SWAR_HIGHS;
+}
+
+///< Marks bytes that are equal to `c`
+static inline swar_t swar_equal(swar_t word, uint8_t c)
+{
+    return swar_zero(word ^ SWAR_REPEAT(c));
+}
+
+///< Marks bytes that are less than `n` (`n` must not be greater than 128)
+static inline swar_t swar_less(swar_t word, uint8_t n)
+{
+    return (word - SWAR_REPEAT(n)) & ~word & SWAR_HIGHS;
+}
+
+// Unlike the functions above, the ones below mark bytes exactly. They are a bit slower, but
+// they can be used when a run of bytes that do NOT match has to be found.
+
+///< Marks bytes that are greater than or equal to `n` (`n` must not be greater than 128)
+static inline swar_t swar_not_less(swar_t word, uint8_t n)
+{
+    return (((word & ~SWAR_HIGHS) + SWAR_REPEAT(0x80 - n)) | word) & SWAR_HIGHS;
+}
+
+///< Marks bytes that are not equal to `c`
+static inline swar_t swar_not_equal(swar_t word, uint8_t c)
+{
+    return swar_not_less(word ^ SWAR_REPEAT(c), 1);
+}
+
+///< Returns the index of the first marked byte. The mask must have at least one byte marked.
+static inline unsigned swar_first(swar_t mask)
+{
+#if defined(__GNUC__)
+    return (SWAR_SIZE == 8 ? __builtin_ctzll(mask) : __builtin_ctzl(mask)) / 8;
+#else
+    unsigned i = 0;
+    while (!(mask & 0x80)) {
+        mask >>= 8;
+        ++i;
+    }
+    return i;
+#endif
+}
+
+#endif
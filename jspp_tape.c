@@ -0,0 +1,164 @@
+#include "jspp_tape.h"
+
+void jspp_tape_init(jspp_tape_t * tape, jspp_tape_entry_t * arena, uint32_t capacity)
+{
+    tape->entries = arena;
+    tape->capacity = capacity;
+    jspp_tape_reset(tape);
+}
+
+void jspp_tape_reset(jspp_tape_t * tape)
+{
+    tape->size = 0;
+    tape->offset = 0;
+    tape->partial = 0;
+    tape->depth = 0;
+    tape->started = 0;
+    tape->split = 0;
+    tape->full = 0;
+}
+
+///< Appends a completely recognized token to the tape
+static uint8_t record(jspp_tape_t * tape, uint8_t token)
+{
+    if (tape->size == tape->capacity) {
+        tape->full = 1;
+        return JSPP_TAPE_FULL;
+    }
+    uint32_t index = tape->size++;
+    jspp_tape_entry_t * entry = &tape->entries[index];
+
+    uint16_t length;
+    const char * text = jspp_text(&tape->parser, &length);
+    uint32_t start = tape->offset + (text - tape->parser.text);
+    uint32_t end = start + length;
+    if (tape->split) {
+        start = tape->partial;
+        tape->split = 0;
+    }
+    entry->token = token;
+    entry->offset = start;
+    entry->length = end - start;
+    entry->jump = index;
+
+    switch (token) {
+        case JSON_OBJECT_BEGIN:
+        case JSON_ARRAY_BEGIN: {
+            tape->open[tape->depth++] = index;
+            break;
+        }
+        case JSON_OBJECT_END:
+        case JSON_ARRAY_END: {
+            uint32_t begin = tape->open[--tape->depth];
+            tape->entries[begin].jump = index;
+            entry->jump = begin;
+            break;
+        }
+    }
+    return token;
+}
+
+///< Remembers where the token that is split between fragments starts
+static void mark_split(jspp_tape_t * tape)
+{
+    if (!tape->split) {
+        uint16_t length;
+        const char * text = jspp_text(&tape->parser, &length);
+        tape->partial = tape->offset + (text - tape->parser.text);
+        tape->split = 1;
+    }
+}
+
+uint8_t jspp_tape_feed(jspp_tape_t * tape, const char * text, uint16_t text_len)
+{
+    jspp_t * parser = &tape->parser;
+    uint8_t token;
+    if (tape->full || text_len > 0xffffffff - tape->offset) {
+        // the offsets of the fragment text would not fit into the entries
+        tape->full = 1;
+        return JSPP_TAPE_FULL;
+    }
+    if (!tape->started) {
+        tape->started = 1;
+        token = jspp_start(parser, text, text_len);
+    } else {
+        token = jspp_continue(parser, text, text_len);
+    }
+
+    while (token > JSON_END) {
+        switch (token) {
+            case JSON_CONTINUE: {
+                // Literals are not returned as partial tokens, but the parser still "opens" a level for them
+                if (parser->level > tape->depth) {
+                    mark_split(tape);
+                }
+                tape->offset += text_len;
+                return JSON_CONTINUE;
+            }
+            case JSON_MEMBER_NAME_PART:
+            case JSON_NUMBER_PART:
+            case JSON_STRING_PART: {
+                mark_split(tape);
+                break;
+            }
+            default: {
+                if (record(tape, token) == JSPP_TAPE_FULL) {
+                    return JSPP_TAPE_FULL;
+                }
+            }
+        }
+        token = jspp_next(parser);
+    }
+    return token;
+}
+
+jspp_cursor_t jspp_tape_cursor(const jspp_tape_t * tape)
+{
+    return (jspp_cursor_t) { tape, 0 };
+}
+
+uint8_t jspp_cursor_token(const jspp_cursor_t * cursor)
+{
+    return cursor->index < cursor->tape->size ? cursor->tape->entries[cursor->index].token : JSON_END;
+}
+
+uint8_t jspp_cursor_next(jspp_cursor_t * cursor)
+{
+    if (cursor->index < cursor->tape->size) {
+        ++cursor->index;
+    }
+    return jspp_cursor_token(cursor);
+}
+
+uint8_t jspp_cursor_skip(jspp_cursor_t * cursor)
+{
+    switch (jspp_cursor_token(cursor)) {
+        case JSON_MEMBER_NAME: {
+            jspp_cursor_next(cursor);
+            return jspp_cursor_skip(cursor);
+        }
+        case JSON_OBJECT_BEGIN:
+        case JSON_ARRAY_BEGIN: {
+            cursor->index = cursor->tape->entries[cursor->index].jump;
+            break;
+        }
+        case JSON_OBJECT_END:
+        case JSON_ARRAY_END:
+        case JSON_END: {
+            // these alone should not be skipped
+            return jspp_cursor_token(cursor);
+        }
+    }
+    return jspp_cursor_next(cursor);
+}
+
+const char * jspp_cursor_text(const jspp_cursor_t * cursor, const char * document, uint32_t * length)
+{
+    if (cursor->index >= cursor->tape->size) {
+        *length = 0;
+        return document;
+    }
+    const jspp_tape_entry_t * entry = &cursor->tape->entries[cursor->index];
+    *length = entry->length;
+    return document + entry->offset;
+}
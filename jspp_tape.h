@@ -0,0 +1,128 @@
+#ifndef __JSPP_TAPE_H
+#define __JSPP_TAPE_H
+
+#include "jspp.h"
+
+#define JSPP_TAPE_FULL 0xff ///< `jspp_tape_feed` result when the tape cannot record the rest of the document
+
+/**
+ * A token recorded on the tape.
+ *
+ * The tape does not keep the token text. It only records where in the JSON stream the text is.
+ * Applications that need the text have to keep the document (or the relevant parts of it)
+ * themselves - for example, when the entire document is in memory or is a memory-mapped file.
+ */
+typedef struct _jspp_tape_entry {
+    uint32_t    offset; ///< Stream offset of the first character of the token text
+    uint32_t    length; ///< Token text length. Like with `jspp_text` quotes are not a part of the text.
+    uint32_t    jump;   ///< OBJECT/ARRAY BEGIN: index of the matching END. OBJECT/ARRAY END: index of the matching BEGIN.
+    uint8_t     token;
+} jspp_tape_entry_t;
+
+typedef struct _jspp_tape {
+    jspp_t              parser;
+    jspp_tape_entry_t * entries;    ///< Caller supplied arena
+    uint32_t            capacity;   ///< Number of entries the arena can hold
+    uint32_t            size;       ///< Number of recorded entries
+    uint32_t            offset;     ///< Stream offset of the current fragment
+    uint32_t            partial;    ///< Stream offset of the token that was split between fragments
+    uint32_t            open[JSON_MAX_STACK]; ///< Indexes of BEGIN entries of open objects and arrays
+    uint8_t             depth;      ///< Number of open objects and arrays
+    uint8_t             started;
+    uint8_t             split;      ///< Set when the token at the `partial` offset is not complete yet
+    uint8_t             full;       ///< Set when the tape cannot record more tokens
+} jspp_tape_t;
+
+/// Lightweight tape navigator
+typedef struct _jspp_cursor {
+    const jspp_tape_t * tape;
+    uint32_t            index;  ///< Index of the current entry
+} jspp_cursor_t;
+
+/**
+ * \brief Prepares the tape builder to record the first document.
+ *
+ * \param tape      A pointer to the tape struct allocated by the caller
+ * \param arena     An array of entries that will hold the tape
+ * \param capacity  Number of entries in the arena
+ */
+void jspp_tape_init(jspp_tape_t * tape, jspp_tape_entry_t * arena, uint32_t capacity);
+
+/**
+ * \brief Discards the recorded tape to prepare the builder for the next document.
+ *
+ * \param tape A pointer to the tape struct
+ */
+void jspp_tape_reset(jspp_tape_t * tape);
+
+/**
+ * \brief Parses the next JSON fragment and records its tokens on the tape.
+ *
+ * \param tape     A pointer to the tape struct
+ * \param text     The next JSON text fragment
+ * \param text_len The length of the text
+ *
+ * \return `JSON_CONTINUE` when the next fragment is needed, `JSON_END` when the entire JSON has been
+ *         recorded, `JSON_INVALID` when the JSON cannot be parsed or `JSON_TOO_DEEP` when JSON is nested
+ *         too deep. `JSPP_TAPE_FULL` is returned when JSON has more tokens than the arena can hold or
+ *         when it is longer than the 4 GiB the 32-bit entry offsets can address.
+ *
+ * Tokens that are split between fragments are recorded as a single entry. Once the tape is full the
+ * following fragments are rejected with `JSPP_TAPE_FULL` as well, until the tape is reset.
+ */
+uint8_t jspp_tape_feed(jspp_tape_t * tape, const char * text, uint16_t text_len);
+
+/**
+ * \brief Returns a cursor that points to the first recorded token.
+ *
+ * \param tape A pointer to the tape struct
+ *
+ * \return Cursor
+ */
+jspp_cursor_t jspp_tape_cursor(const jspp_tape_t * tape);
+
+/**
+ * \brief Returns the token at the cursor position.
+ *
+ * \param cursor A pointer to the cursor
+ *
+ * \return The token ID or `JSON_END` when the cursor moved past the last recorded token.
+ */
+uint8_t jspp_cursor_token(const jspp_cursor_t * cursor);
+
+/**
+ * \brief Moves cursor to the next token.
+ *
+ * \param cursor A pointer to the cursor
+ *
+ * \return The token ID
+ *
+ * Like `jspp_next` this function moves from token to token, i.e. it enters objects and arrays.
+ */
+uint8_t jspp_cursor_next(jspp_cursor_t * cursor);
+
+/**
+ * \brief Moves cursor past the current element.
+ *
+ * \param cursor A pointer to the cursor
+ *
+ * \return The ID of the token after the skipped element
+ *
+ * Like `jspp_skip` this function skips elements. When the current token is `JSON_OBJECT_BEGIN`
+ * or `JSON_ARRAY_BEGIN` the entire object or array is skipped in one step. When the current token
+ * is `JSON_MEMBER_NAME`, then the member value is skipped as well.
+ */
+uint8_t jspp_cursor_skip(jspp_cursor_t * cursor);
+
+/**
+ * \brief Returns a pointer to the text of the current token.
+ *
+ * \param      cursor   A pointer to the cursor
+ * \param      document Pointer to the beginning of the JSON document the tape was recorded from
+ * \param[out] length   A pointer to the variable in which the length of the token text will be returned
+ *
+ * \return Pointer to the token text.
+ */
+const char * jspp_cursor_text(const jspp_cursor_t * cursor, const char * document, uint32_t * length);
+
+#endif
@@ -0,0 +1,566 @@
+#include "jspp_transcode.h"
+#include "jspp_conv.h"
+#include "jspp_swar.h"
+#include <stddef.h>
+
+///< `string_header` value when no string is being written
+#define NO_STRING 0xffffffff
+
+// Escape sequence decoder states
+#define ESC_NONE                0
+#define ESC_BACKSLASH           1   ///< `\` has been seen
+#define ESC_HEX                 2   ///< Hex digits of `\u` are being decoded
+#define ESC_SURROGATE           3   ///< High surrogate has been decoded, `\` of its low pair is expected
+#define ESC_SURROGATE_BACKSLASH 4   ///< `u` of the low surrogate escape is expected
+
+#define REPLACEMENT_CHARACTER   0xfffd
+
+void jspp_transcoder_init(jspp_transcoder_t * transcoder, uint8_t format, uint8_t * buffer, uint32_t size,
+    jspp_flush_t flush, void * flush_data)
+{
+    transcoder->buffer = buffer;
+    transcoder->buffer_size = size;
+    transcoder->length = 0;
+    transcoder->flush = flush;
+    transcoder->flush_data = flush_data;
+    transcoder->string_header = NO_STRING;
+    transcoder->level = 0;
+    transcoder->maps[0] = 0;
+    transcoder->format = format;
+    transcoder->started = 0;
+    transcoder->partial = 0;
+    transcoder->escape_state = ESC_NONE;
+    transcoder->high_surrogate = 0;
+    transcoder->text_length = 0;
+}
+
+///< Passes the encoded data that will not change anymore to the flush callback
+static void flush_stable(jspp_transcoder_t * transcoder)
+{
+    if (!transcoder->flush) {
+        return;
+    }
+    uint32_t stable = transcoder->length;
+    if (transcoder->format == JSPP_MSGPACK && transcoder->level > 0) {
+        stable = transcoder->headers[1];
+    }
+    if (transcoder->string_header < stable) {
+        stable = transcoder->string_header;
+    }
+    if (stable == 0) {
+        return;
+    }
+
+    uint8_t * buffer = transcoder->buffer;
+    for (uint32_t offset = 0; offset < stable;) {
+        uint32_t size = stable - offset;
+        if (size > 0xffff) {
+            size = 0xffff;
+        }
+        transcoder->flush((const char *) buffer + offset, (uint16_t) size, transcoder->flush_data);
+        offset += size;
+    }
+    // move the data that is still being written to the beginning of the buffer
+    for (uint32_t i = stable; i < transcoder->length; i++) {
+        buffer[i - stable] = buffer[i];
+    }
+    transcoder->length -= stable;
+    if (transcoder->format == JSPP_MSGPACK) {
+        for (uint8_t level = 1; level <= transcoder->level; level++) {
+            transcoder->headers[level] -= stable;
+        }
+    }
+    if (transcoder->string_header != NO_STRING) {
+        transcoder->string_header -= stable;
+    }
+}
+
+///< Reserves space in the output buffer. Returns NULL when the buffer is full.
+static uint8_t * reserve(jspp_transcoder_t * transcoder, uint32_t size)
+{
+    if (transcoder->buffer_size - transcoder->length < size) {
+        flush_stable(transcoder);
+        if (transcoder->buffer_size - transcoder->length < size) {
+            return NULL;
+        }
+    }
+    uint8_t * ptr = transcoder->buffer + transcoder->length;
+    transcoder->length += size;
+    return ptr;
+}
+
+static int put_bytes(jspp_transcoder_t * transcoder, const char * data, uint32_t size)
+{
+    while (size > 0) {
+        uint32_t room = transcoder->buffer_size - transcoder->length;
+        if (room == 0) {
+            flush_stable(transcoder);
+            room = transcoder->buffer_size - transcoder->length;
+            if (room == 0) {
+                return 0;
+            }
+        }
+        uint32_t n = size < room ? size : room;
+        uint8_t * dst = transcoder->buffer + transcoder->length;
+        for (uint32_t i = 0; i < n; i++) {
+            dst[i] = (uint8_t) data[i];
+        }
+        transcoder->length += n;
+        data += n;
+        size -= n;
+    }
+    return 1;
+}
+
+///< Stores the value in the big-endian order
+static void store_be(uint8_t * dst, uint64_t value, uint8_t size)
+{
+    while (size-- > 0) {
+        dst[size] = (uint8_t) value;
+        value >>= 8;
+    }
+}
+
+///< Writes the initial byte followed by `size` bytes of the value in the big-endian order
+static int put_head(jspp_transcoder_t * transcoder, uint8_t initial, uint64_t value, uint8_t size)
+{
+    uint8_t * dst = reserve(transcoder, 1 + size);
+    if (!dst) {
+        return 0;
+    }
+    dst[0] = initial;
+    store_be(dst + 1, value, size);
+    return 1;
+}
+
+///< Writes CBOR major type with its argument
+static int put_cbor_head(jspp_transcoder_t * transcoder, uint8_t major, uint64_t value)
+{
+    if (value < 24) {
+        return put_head(transcoder, major | (uint8_t) value, 0, 0);
+    }
+    if (value <= 0xff) {
+        return put_head(transcoder, major | 24, value, 1);
+    }
+    if (value <= 0xffff) {
+        return put_head(transcoder, major | 25, value, 2);
+    }
+    if (value <= 0xffffffff) {
+        return put_head(transcoder, major | 26, value, 4);
+    }
+    return put_head(transcoder, major | 27, value, 8);
+}
+
+static int put_integer(jspp_transcoder_t * transcoder, int64_t value)
+{
+    if (transcoder->format == JSPP_CBOR) {
+        // negative integers are encoded as -1 - n
+        return value < 0 ? put_cbor_head(transcoder, 0x20, ~(uint64_t) value) : put_cbor_head(transcoder, 0x00, value);
+    }
+    if (value >= 0) {
+        if (value < 0x80) {
+            return put_head(transcoder, (uint8_t) value, 0, 0); // positive fixint
+        }
+        if (value <= 0xff) {
+            return put_head(transcoder, 0xcc, value, 1);
+        }
+        if (value <= 0xffff) {
+            return put_head(transcoder, 0xcd, value, 2);
+        }
+        if (value <= 0xffffffff) {
+            return put_head(transcoder, 0xce, value, 4);
+        }
+        return put_head(transcoder, 0xcf, value, 8);
+    }
+    if (value >= -32) {
+        return put_head(transcoder, (uint8_t) value, 0, 0); // negative fixint
+    }
+    if (value >= INT8_MIN) {
+        return put_head(transcoder, 0xd0, value, 1);
+    }
+    if (value >= INT16_MIN) {
+        return put_head(transcoder, 0xd1, value, 2);
+    }
+    if (value >= INT32_MIN) {
+        return put_head(transcoder, 0xd2, value, 4);
+    }
+    return put_head(transcoder, 0xd3, value, 8);
+}
+
+static int put_double(jspp_transcoder_t * transcoder, double value)
+{
+    union {
+        double   d;
+        uint64_t u;
+    } bits = { value };
+    return put_head(transcoder, transcoder->format == JSPP_CBOR ? 0xfb : 0xcb, bits.u, 8);
+}
+
+static int put_number(jspp_transcoder_t * transcoder, uint8_t token, const char * text, uint16_t length)
+{
+    int64_t i;
+    double d;
+    if (token == JSON_INTEGER && jspp_scan_int64(text, length, &i) == length) {
+        return put_integer(transcoder, i);
+    }
+    // decimals, floating point numbers and integers that do not fit into 64 bits
+    if (jspp_scan_double(text, length, &d) != length) {
+        return 0;
+    }
+    return put_double(transcoder, d);
+}
+
+///< Appends the text of the number that is split between fragments to the side buffer
+static int collect_number(jspp_transcoder_t * transcoder, const char * text, uint16_t length)
+{
+    if (transcoder->text_length + length > JSPP_TRANSCODE_TEXT_SIZE) {
+        return 0;
+    }
+    char * dst = transcoder->text + transcoder->text_length;
+    for (uint16_t i = 0; i < length; i++) {
+        dst[i] = text[i];
+    }
+    transcoder->text_length += length;
+    return 1;
+}
+
+static int put_code_point(jspp_transcoder_t * transcoder, uint32_t code)
+{
+    char utf8[4];
+    uint8_t size;
+    if (code < 0x80) {
+        utf8[0] = (char) code;
+        size = 1;
+    } else if (code < 0x800) {
+        utf8[0] = (char) (0xc0 | (code >> 6));
+        utf8[1] = (char) (0x80 | (code & 0x3f));
+        size = 2;
+    } else if (code < 0x10000) {
+        utf8[0] = (char) (0xe0 | (code >> 12));
+        utf8[1] = (char) (0x80 | ((code >> 6) & 0x3f));
+        utf8[2] = (char) (0x80 | (code & 0x3f));
+        size = 3;
+    } else {
+        utf8[0] = (char) (0xf0 | (code >> 18));
+        utf8[1] = (char) (0x80 | ((code >> 12) & 0x3f));
+        utf8[2] = (char) (0x80 | ((code >> 6) & 0x3f));
+        utf8[3] = (char) (0x80 | (code & 0x3f));
+        size = 4;
+    }
+    return put_bytes(transcoder, utf8, size);
+}
+
+static inline uint8_t hex_value(char c)
+{
+    return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+}
+
+///< Decodes the next character of an escape sequence
+static int decode_escape(jspp_transcoder_t * transcoder, char c)
+{
+    switch (transcoder->escape_state) {
+        case ESC_SURROGATE: {
+            if (c == '\\') {
+                transcoder->escape_state = ESC_SURROGATE_BACKSLASH;
+                return 1;
+            }
+            // high surrogate without its low pair
+            transcoder->escape_state = ESC_NONE;
+            transcoder->high_surrogate = 0;
+            return put_code_point(transcoder, REPLACEMENT_CHARACTER) && put_bytes(transcoder, &c, 1);
+        }
+        case ESC_SURROGATE_BACKSLASH: {
+            if (c == 'u') {
+                transcoder->escape_state = ESC_HEX;
+                transcoder->escape_digits = 0;
+                transcoder->escape_code = 0;
+                return 1;
+            }
+            transcoder->high_surrogate = 0;
+            if (!put_code_point(transcoder, REPLACEMENT_CHARACTER)) {
+                return 0;
+            }
+        }
+        // fall through
+        case ESC_BACKSLASH: {
+            switch (c) {
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'u': {
+                    transcoder->escape_state = ESC_HEX;
+                    transcoder->escape_digits = 0;
+                    transcoder->escape_code = 0;
+                    return 1;
+                }
+            }
+            // `"`, `\` and `/` stand for themselves
+            transcoder->escape_state = ESC_NONE;
+            return put_bytes(transcoder, &c, 1);
+        }
+    }
+
+    // ESC_HEX
+    transcoder->escape_code = transcoder->escape_code << 4 | hex_value(c);
+    if (++transcoder->escape_digits < 4) {
+        return 1;
+    }
+    uint16_t code = transcoder->escape_code;
+    transcoder->escape_state = ESC_NONE;
+    if (transcoder->high_surrogate) {
+        uint16_t high = transcoder->high_surrogate;
+        transcoder->high_surrogate = 0;
+        if (0xdc00 <= code && code <= 0xdfff) {
+            return put_code_point(transcoder, 0x10000 + ((uint32_t) (high - 0xd800) << 10) + (code - 0xdc00));
+        }
+        if (!put_code_point(transcoder, REPLACEMENT_CHARACTER)) {
+            return 0;
+        }
+    }
+    if (0xd800 <= code && code <= 0xdbff) {
+        transcoder->high_surrogate = code;
+        transcoder->escape_state = ESC_SURROGATE;
+        return 1;
+    }
+    return put_code_point(transcoder, 0xdc00 <= code && code <= 0xdfff ? REPLACEMENT_CHARACTER : code);
+}
+
+///< Returns the pointer to the first backslash or the end of the text
+static const char * find_backslash(const char * text, const char * end)
+{
+    while (end - text >= (ptrdiff_t) SWAR_SIZE) {
+        swar_t mask = swar_equal(swar_load(text), '\\');
+        if (mask) {
+            return text + swar_first(mask);
+        }
+        text += SWAR_SIZE;
+    }
+    while (text < end && *text != '\\') {
+        ++text;
+    }
+    return text;
+}
+
+///< Decodes (a part of) the string text into the output buffer
+static int put_string_text(jspp_transcoder_t * transcoder, const char * text, uint16_t length)
+{
+    const char * end = text + length;
+    while (text < end) {
+        if (transcoder->escape_state != ESC_NONE) {
+            if (!decode_escape(transcoder, *text++)) {
+                return 0;
+            }
+            continue;
+        }
+        const char * run = text;
+        text = find_backslash(text, end);
+        if (!put_bytes(transcoder, run, text - run)) {
+            return 0;
+        }
+        if (text < end) {
+            transcoder->escape_state = ESC_BACKSLASH;
+            ++text;
+        }
+    }
+    return 1;
+}
+
+/**
+ * \brief Replaces the reserved 5-byte header with the shorter one and moves the data that follows it back.
+ *
+ * \param transcoder A pointer to the transcoder struct
+ * \param header     Buffer offset of the reserved header
+ * \param initial    The initial byte of the new header
+ * \param value      The length or the number of elements that follows the initial byte
+ * \param size       The number of bytes of the value - 0, 1, 2 or 4
+ */
+static void rewrite_header(jspp_transcoder_t * transcoder, uint32_t header, uint8_t initial, uint32_t value, uint8_t size)
+{
+    uint8_t * buffer = transcoder->buffer;
+    buffer[header] = initial;
+    store_be(buffer + header + 1, value, size);
+    uint8_t shift = 4 - size;
+    if (shift == 0) {
+        return;
+    }
+    for (uint32_t i = header + 5; i < transcoder->length; i++) {
+        buffer[i - shift] = buffer[i];
+    }
+    transcoder->length -= shift;
+}
+
+static int begin_string(jspp_transcoder_t * transcoder)
+{
+    transcoder->string_header = transcoder->length;
+    return put_head(transcoder, transcoder->format == JSPP_CBOR ? 0x7a : 0xdb, 0, 4);
+}
+
+static int end_string(jspp_transcoder_t * transcoder)
+{
+    if (transcoder->escape_state == ESC_SURROGATE) {
+        transcoder->escape_state = ESC_NONE;
+        transcoder->high_surrogate = 0;
+        if (!put_code_point(transcoder, REPLACEMENT_CHARACTER)) {
+            return 0;
+        }
+    }
+    uint32_t header = transcoder->string_header;
+    uint32_t length = transcoder->length - header - 5;
+    transcoder->string_header = NO_STRING;
+    if (transcoder->format == JSPP_CBOR) {
+        if (length < 24) {
+            rewrite_header(transcoder, header, 0x60 | (uint8_t) length, 0, 0);
+        } else if (length <= 0xff) {
+            rewrite_header(transcoder, header, 0x78, length, 1);
+        } else if (length <= 0xffff) {
+            rewrite_header(transcoder, header, 0x79, length, 2);
+        } else {
+            rewrite_header(transcoder, header, 0x7a, length, 4);
+        }
+    } else if (length < 32) {
+        rewrite_header(transcoder, header, 0xa0 | (uint8_t) length, 0, 0); // fixstr
+    } else if (length <= 0xff) {
+        rewrite_header(transcoder, header, 0xd9, length, 1);
+    } else if (length <= 0xffff) {
+        rewrite_header(transcoder, header, 0xda, length, 2);
+    } else {
+        rewrite_header(transcoder, header, 0xdb, length, 4);
+    }
+    return 1;
+}
+
+static int begin_container(jspp_transcoder_t * transcoder, uint8_t is_map)
+{
+    uint8_t level = ++transcoder->level;
+    transcoder->maps[level] = is_map;
+    if (transcoder->format == JSPP_CBOR) {
+        // indefinite length map or array
+        return put_head(transcoder, is_map ? 0xbf : 0x9f, 0, 0);
+    }
+    transcoder->headers[level] = transcoder->length;
+    transcoder->counts[level] = 0;
+    return put_head(transcoder, is_map ? 0xdf : 0xdd, 0, 4);
+}
+
+static int end_container(jspp_transcoder_t * transcoder)
+{
+    uint8_t level = transcoder->level--;
+    if (transcoder->format == JSPP_CBOR) {
+        return put_head(transcoder, 0xff, 0, 0); // "break"
+    }
+    uint32_t count = transcoder->counts[level];
+    uint8_t is_map = transcoder->maps[level];
+    if (count < 16) {
+        // fixmap or fixarray
+        rewrite_header(transcoder, transcoder->headers[level], (is_map ? 0x80 : 0x90) | (uint8_t) count, 0, 0);
+    } else if (count <= 0xffff) {
+        rewrite_header(transcoder, transcoder->headers[level], is_map ? 0xde : 0xdc, count, 2);
+    } else {
+        rewrite_header(transcoder, transcoder->headers[level], is_map ? 0xdf : 0xdd, count, 4);
+    }
+    return 1;
+}
+
+///< Counts the value that is about to be written
+static inline void count_value(jspp_transcoder_t * transcoder)
+{
+    // map sizes are counted by member names
+    if (!transcoder->maps[transcoder->level]) {
+        ++transcoder->counts[transcoder->level];
+    }
+}
+
+static int transcode_token(jspp_transcoder_t * transcoder, uint8_t token)
+{
+    uint16_t length;
+    const char * text = jspp_text(&transcoder->parser, &length);
+
+    switch (token) {
+        case JSON_OBJECT_BEGIN:
+        case JSON_ARRAY_BEGIN: {
+            count_value(transcoder);
+            return begin_container(transcoder, token == JSON_OBJECT_BEGIN);
+        }
+        case JSON_OBJECT_END:
+        case JSON_ARRAY_END: {
+            return end_container(transcoder);
+        }
+        case JSON_NULL: {
+            count_value(transcoder);
+            return put_head(transcoder, transcoder->format == JSPP_CBOR ? 0xf6 : 0xc0, 0, 0);
+        }
+        case JSON_TRUE: {
+            count_value(transcoder);
+            return put_head(transcoder, transcoder->format == JSPP_CBOR ? 0xf5 : 0xc3, 0, 0);
+        }
+        case JSON_FALSE: {
+            count_value(transcoder);
+            return put_head(transcoder, transcoder->format == JSPP_CBOR ? 0xf4 : 0xc2, 0, 0);
+        }
+        case JSON_MEMBER_NAME_PART:
+        case JSON_MEMBER_NAME:
+        case JSON_STRING_PART:
+        case JSON_STRING: {
+            if (!transcoder->partial) {
+                if (token == JSON_MEMBER_NAME_PART || token == JSON_MEMBER_NAME) {
+                    ++transcoder->counts[transcoder->level];
+                } else {
+                    count_value(transcoder);
+                }
+                if (!begin_string(transcoder)) {
+                    return 0;
+                }
+            }
+            if (!put_string_text(transcoder, text, length)) {
+                return 0;
+            }
+            transcoder->partial = token == JSON_MEMBER_NAME_PART || token == JSON_STRING_PART;
+            return transcoder->partial || end_string(transcoder);
+        }
+        case JSON_NUMBER_PART: {
+            if (!transcoder->partial) {
+                count_value(transcoder);
+                transcoder->partial = 1;
+            }
+            return collect_number(transcoder, text, length);
+        }
+        case JSON_INTEGER:
+        case JSON_DECIMAL:
+        case JSON_FLOATING_POINT: {
+            if (!transcoder->partial) {
+                count_value(transcoder);
+                return put_number(transcoder, token, text, length);
+            }
+            transcoder->partial = 0;
+            int collected = collect_number(transcoder, text, length);
+            uint16_t text_length = transcoder->text_length;
+            transcoder->text_length = 0;
+            return collected && put_number(transcoder, token, transcoder->text, text_length);
+        }
+    }
+    return 0;
+}
+
+uint8_t jspp_transcode_feed(jspp_transcoder_t * transcoder, const char * text, uint16_t text_len)
+{
+    uint8_t token;
+    if (!transcoder->started) {
+        transcoder->started = 1;
+        token = jspp_start(&transcoder->parser, text, text_len);
+    } else {
+        token = jspp_continue(&transcoder->parser, text, text_len);
+    }
+
+    while (token > JSON_CONTINUE) {
+        if (!transcode_token(transcoder, token)) {
+            return JSON_TOO_DEEP;
+        }
+        token = jspp_next(&transcoder->parser);
+    }
+    if (token == JSON_CONTINUE || token == JSON_END) {
+        flush_stable(transcoder);
+    }
+    return token;
+}
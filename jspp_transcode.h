@@ -0,0 +1,78 @@
+#ifndef __JSPP_TRANSCODE_H
+#define __JSPP_TRANSCODE_H
+
+#include "jspp.h"
+#include "jspp_writer.h"
+
+#ifndef JSPP_TRANSCODE_TEXT_SIZE
+#define JSPP_TRANSCODE_TEXT_SIZE 64 ///< Size of the buffer that collects numbers split between fragments
+#endif
+
+enum _jspp_transcode_formats {
+    JSPP_MSGPACK,   ///< MessagePack
+    JSPP_CBOR       ///< CBOR (RFC 8949)
+};
+
+typedef struct _jspp_transcoder {
+    jspp_t          parser;
+    uint8_t *       buffer;         ///< Caller provided output buffer
+    uint32_t        buffer_size;
+    uint32_t        length;         ///< Number of bytes in the buffer
+    jspp_flush_t    flush;
+    void *          flush_data;
+    uint32_t        headers[JSON_MAX_STACK];    ///< MessagePack: buffer offsets of the headers of open maps and arrays
+    uint32_t        counts[JSON_MAX_STACK];     ///< MessagePack: number of elements in open maps and arrays
+    uint32_t        string_header;  ///< Buffer offset of the header of the string that is being written
+    uint8_t         maps[JSON_MAX_STACK];       ///< Set for levels that are maps
+    uint8_t         level;          ///< Number of open maps and arrays
+    uint8_t         format;         ///< One of the `_jspp_transcode_formats`
+    uint8_t         started;
+    uint8_t         partial;        ///< Set while a token that is split between fragments is being transcoded
+    uint8_t         escape_state;   ///< State of the escape sequence decoder
+    uint8_t         escape_digits;  ///< Number of `\u` hex digits decoded so far
+    uint16_t        escape_code;    ///< Code unit of the `\u` escape
+    uint16_t        high_surrogate; ///< High surrogate that is waiting for its low pair
+    uint16_t        text_length;    ///< Length of the number collected so far
+    char            text[JSPP_TRANSCODE_TEXT_SIZE];
+} jspp_transcoder_t;
+
+/**
+ * \brief Prepares the transcoder to convert a JSON document.
+ *
+ * \param transcoder A pointer to the transcoder struct allocated by the caller
+ * \param format     The output format - `JSPP_MSGPACK` or `JSPP_CBOR`
+ * \param buffer     Output buffer
+ * \param size       The size of the output buffer
+ * \param flush      The function that receives the encoded data that is complete. It might be NULL
+ *                   if the encoded document is expected to fit into the buffer.
+ * \param flush_data The pointer that is passed to the `flush` callback
+ */
+void jspp_transcoder_init(jspp_transcoder_t * transcoder, uint8_t format, uint8_t * buffer, uint32_t size,
+    jspp_flush_t flush, void * flush_data);
+
+/**
+ * \brief Transcodes the next JSON fragment.
+ *
+ * \param transcoder A pointer to the transcoder struct
+ * \param text       The next JSON text fragment
+ * \param text_len   The length of the text
+ *
+ * \return `JSON_CONTINUE` when the next fragment is needed, `JSON_END` when the entire JSON has been
+ *         transcoded, `JSON_INVALID` when the JSON cannot be parsed, or `JSON_TOO_DEEP` when JSON is
+ *         nested too deep or the encoded data does not fit into the buffer.
+ *
+ * Lengths of maps, arrays and strings are not known until they end. The transcoder reserves 5-byte
+ * headers for them (MessagePack map32, array32 and str32, CBOR text string with a 4-byte length).
+ * When an item ends its header is replaced with the smallest one that holds its length and the
+ * item data is moved back to follow it. CBOR maps and arrays use indefinite length encoding instead.
+ * Either way the data after an incomplete header must stay in the buffer, so only the encoded data
+ * before it is passed to the `flush` callback. For MessagePack that means that the entire top level
+ * map or array, with the 5-byte headers of the items that are still open, must fit into the buffer.
+ *
+ * Integers are encoded in the smallest integer format that holds them. Integers that do not fit into
+ * 64 bits as well as decimal and floating point numbers are encoded as 64-bit floats. String escape
+ * sequences are decoded into UTF-8.
+ */
+uint8_t jspp_transcode_feed(jspp_transcoder_t * transcoder, const char * text, uint16_t text_len);
+
+#endif
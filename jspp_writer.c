@@ -0,0 +1,661 @@
+#include "jspp_writer.h"
+#include "jspp_swar.h"
+
+// Writer stack flags
+#define W_OBJECT    1   ///< The level is an object
+#define W_NOT_EMPTY 2   ///< At least one element has been written at this level
+#define W_NAME      4   ///< Member name has been written and the member value is expected
+#define W_PARTIAL   8   ///< The token has been written only partially
+
+///< Returned by internal functions when the text has been written successfully
+#define WRITE_OK    0xff
+
+void jspp_writer_init(jspp_writer_t * writer, char * buffer, uint16_t size, jspp_flush_t flush, void * flush_data)
+{
+    writer->buffer = buffer;
+    writer->buffer_size = size;
+    writer->length = 0;
+    writer->flush = flush;
+    writer->flush_data = flush_data;
+    writer->level = 0;
+    writer->stack[0] = 0;
+}
+
+uint8_t jspp_write_flush(jspp_writer_t * writer)
+{
+    if (writer->flush && writer->length > 0) {
+        writer->flush(writer->buffer, writer->length, writer->flush_data);
+        writer->length = 0;
+    }
+    return writer->level == 0 ? JSON_END : JSON_CONTINUE;
+}
+
+///< Copies text into the output buffer flushing it when it is full
+static uint8_t put(jspp_writer_t * writer, const char * text, uint16_t text_len)
+{
+    while (text_len > 0) {
+        uint16_t room = writer->buffer_size - writer->length;
+        if (room == 0) {
+            if (!writer->flush) {
+                return JSON_TOO_DEEP;
+            }
+            jspp_write_flush(writer);
+            room = writer->buffer_size;
+        }
+        uint16_t size = text_len < room ? text_len : room;
+        char * dst = writer->buffer + writer->length;
+        for (uint16_t i = 0; i < size; i++) {
+            dst[i] = text[i];
+        }
+        writer->length += size;
+        text += size;
+        text_len -= size;
+    }
+    return WRITE_OK;
+}
+
+static inline uint8_t put_char(jspp_writer_t * writer, char c)
+{
+    if (writer->length < writer->buffer_size) {
+        writer->buffer[writer->length++] = c;
+        return WRITE_OK;
+    }
+    return put(writer, &c, 1);
+}
+
+///< Writes a separator before the value, if one is needed, and checks that a value can be written at this point
+static uint8_t begin_value(jspp_writer_t * writer)
+{
+    uint8_t * flags = &writer->stack[writer->level];
+    if (*flags & W_PARTIAL) {
+        return JSON_INVALID;
+    }
+    if (*flags & W_OBJECT) {
+        if (!(*flags & W_NAME)) {
+            return JSON_INVALID;
+        }
+        *flags &= ~W_NAME;
+        return WRITE_OK;
+    }
+    if (*flags & W_NOT_EMPTY) {
+        if (put_char(writer, writer->level > 0 ? ',' : '\n') != WRITE_OK) {
+            return JSON_TOO_DEEP;
+        }
+    }
+    *flags |= W_NOT_EMPTY;
+    return WRITE_OK;
+}
+
+///< Writes a scalar value
+static uint8_t write_value(jspp_writer_t * writer, uint8_t token, const char * text, uint16_t text_len)
+{
+    uint8_t rc = begin_value(writer);
+    if (rc != WRITE_OK) {
+        return rc;
+    }
+    return put(writer, text, text_len) == WRITE_OK ? token : JSON_TOO_DEEP;
+}
+
+static uint8_t begin_composite(jspp_writer_t * writer, uint8_t token, char c, uint8_t flags)
+{
+    if (writer->level + 1 >= JSON_MAX_STACK) {
+        return JSON_TOO_DEEP;
+    }
+    uint8_t rc = begin_value(writer);
+    if (rc != WRITE_OK) {
+        return rc;
+    }
+    if (put_char(writer, c) != WRITE_OK) {
+        return JSON_TOO_DEEP;
+    }
+    writer->stack[++writer->level] = flags;
+    return token;
+}
+
+static uint8_t end_composite(jspp_writer_t * writer, uint8_t token, char c, uint8_t flags)
+{
+    uint8_t level_flags = writer->stack[writer->level];
+    if (writer->level == 0 || (level_flags & W_OBJECT) != flags || (level_flags & (W_NAME | W_PARTIAL))) {
+        return JSON_INVALID;
+    }
+    if (put_char(writer, c) != WRITE_OK) {
+        return JSON_TOO_DEEP;
+    }
+    --writer->level;
+    return token;
+}
+
+uint8_t jspp_write_object_begin(jspp_writer_t * writer)
+{
+    return begin_composite(writer, JSON_OBJECT_BEGIN, '{', W_OBJECT);
+}
+
+uint8_t jspp_write_object_end(jspp_writer_t * writer)
+{
+    return end_composite(writer, JSON_OBJECT_END, '}', W_OBJECT);
+}
+
+uint8_t jspp_write_array_begin(jspp_writer_t * writer)
+{
+    return begin_composite(writer, JSON_ARRAY_BEGIN, '[', 0);
+}
+
+uint8_t jspp_write_array_end(jspp_writer_t * writer)
+{
+    return end_composite(writer, JSON_ARRAY_END, ']', 0);
+}
+
+uint8_t jspp_write_null(jspp_writer_t * writer)
+{
+    return write_value(writer, JSON_NULL, "null", 4);
+}
+
+uint8_t jspp_write_bool(jspp_writer_t * writer, int value)
+{
+    return value ? write_value(writer, JSON_TRUE, "true", 4) : write_value(writer, JSON_FALSE, "false", 5);
+}
+
+static const char digit_pairs[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+ * \brief Formats an unsigned integer.
+ *
+ * \param end Pointer to the end of the buffer. Digits are written backwards from there.
+ * \param val The value
+ *
+ * \return Pointer to the first digit
+ */
+static char * format_uint(char * end, uint64_t val)
+{
+    while (val >= 100) {
+        const char * pair = digit_pairs + (val % 100) * 2;
+        val /= 100;
+        *--end = pair[1];
+        *--end = pair[0];
+    }
+    if (val >= 10) {
+        const char * pair = digit_pairs + val * 2;
+        *--end = pair[1];
+        *--end = pair[0];
+    } else {
+        *--end = (char) ('0' + val);
+    }
+    return end;
+}
+
+uint8_t jspp_write_integer(jspp_writer_t * writer, int64_t value)
+{
+    char buf[24];
+    char * end = buf + sizeof(buf);
+    char * ptr = format_uint(end, value < 0 ? 0 - (uint64_t) value : (uint64_t) value);
+    if (value < 0) {
+        *--ptr = '-';
+    }
+    return write_value(writer, JSON_INTEGER, ptr, end - ptr);
+}
+
+// Double to shortest decimal conversion (Grisu2 by Florian Loitsch, "Printing Floating-Point
+// Numbers Quickly and Accurately with Integers", PLDI 2010)
+
+#define DP_SIGNIFICAND_MASK 0x000fffffffffffffull
+#define DP_EXPONENT_MASK    0x7ff0000000000000ull
+#define DP_HIDDEN_BIT       0x0010000000000000ull
+#define DP_SIGNIFICAND_SIZE 52
+#define DP_EXPONENT_BIAS    (0x3ff + DP_SIGNIFICAND_SIZE)
+
+///< "Do-it-yourself" floating point number - f * 2^e
+typedef struct _diy_fp {
+    uint64_t f;
+    int      e;
+} diy_fp_t;
+
+///< Normalized significands of 10^-348, 10^-340, ..., 10^340
+static const uint64_t cached_powers_f[] = {
+    0xfa8fd5a0081c0288, 0xbaaee17fa23ebf76, 0x8b16fb203055ac76, 0xcf42894a5dce35ea,
+    0x9a6bb0aa55653b2d, 0xe61acf033d1a45df, 0xab70fe17c79ac6ca, 0xff77b1fcbebcdc4f,
+    0xbe5691ef416bd60c, 0x8dd01fad907ffc3c, 0xd3515c2831559a83, 0x9d71ac8fada6c9b5,
+    0xea9c227723ee8bcb, 0xaecc49914078536d, 0x823c12795db6ce57, 0xc21094364dfb5637,
+    0x9096ea6f3848984f, 0xd77485cb25823ac7, 0xa086cfcd97bf97f4, 0xef340a98172aace5,
+    0xb23867fb2a35b28e, 0x84c8d4dfd2c63f3b, 0xc5dd44271ad3cdba, 0x936b9fcebb25c996,
+    0xdbac6c247d62a584, 0xa3ab66580d5fdaf6, 0xf3e2f893dec3f126, 0xb5b5ada8aaff80b8,
+    0x87625f056c7c4a8b, 0xc9bcff6034c13053, 0x964e858c91ba2655, 0xdff9772470297ebd,
+    0xa6dfbd9fb8e5b88f, 0xf8a95fcf88747d94, 0xb94470938fa89bcf, 0x8a08f0f8bf0f156b,
+    0xcdb02555653131b6, 0x993fe2c6d07b7fac, 0xe45c10c42a2b3b06, 0xaa242499697392d3,
+    0xfd87b5f28300ca0e, 0xbce5086492111aeb, 0x8cbccc096f5088cc, 0xd1b71758e219652c,
+    0x9c40000000000000, 0xe8d4a51000000000, 0xad78ebc5ac620000, 0x813f3978f8940984,
+    0xc097ce7bc90715b3, 0x8f7e32ce7bea5c70, 0xd5d238a4abe98068, 0x9f4f2726179a2245,
+    0xed63a231d4c4fb27, 0xb0de65388cc8ada8, 0x83c7088e1aab65db, 0xc45d1df942711d9a,
+    0x924d692ca61be758, 0xda01ee641a708dea, 0xa26da3999aef774a, 0xf209787bb47d6b85,
+    0xb454e4a179dd1877, 0x865b86925b9bc5c2, 0xc83553c5c8965d3d, 0x952ab45cfa97a0b3,
+    0xde469fbd99a05fe3, 0xa59bc234db398c25, 0xf6c69a72a3989f5c, 0xb7dcbf5354e9bece,
+    0x88fcf317f22241e2, 0xcc20ce9bd35c78a5, 0x98165af37b2153df, 0xe2a0b5dc971f303a,
+    0xa8d9d1535ce3b396, 0xfb9b7cd9a4a7443c, 0xbb764c4ca7a44410, 0x8bab8eefb6409c1a,
+    0xd01fef10a657842c, 0x9b10a4e5e9913129, 0xe7109bfba19c0c9d, 0xac2820d9623bf429,
+    0x80444b5e7aa7cf85, 0xbf21e44003acdd2d, 0x8e679c2f5e44ff8f, 0xd433179d9c8cb841,
+    0x9e19db92b4e31ba9, 0xeb96bf6ebadf77d9, 0xaf87023b9bf0ee6b
+};
+
+///< Binary exponents of the cached powers of 10
+static const int16_t cached_powers_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066
+};
+
+static const uint64_t powers_of_10[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull, 10000000000000000000ull
+};
+
+static diy_fp_t fp_multiply(diy_fp_t x, diy_fp_t y)
+{
+    const uint64_t M32 = 0xffffffff;
+    uint64_t a = x.f >> 32;
+    uint64_t b = x.f & M32;
+    uint64_t c = y.f >> 32;
+    uint64_t d = y.f & M32;
+    uint64_t ac = a * c;
+    uint64_t bc = b * c;
+    uint64_t ad = a * d;
+    uint64_t bd = b * d;
+    uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+    tmp += 1u << 31; // round
+    return (diy_fp_t) { ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64 };
+}
+
+static diy_fp_t fp_normalize(diy_fp_t x)
+{
+    while (!(x.f & (1ull << 63))) {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+///< Computes the boundaries of the interval of numbers that are converted to the same double
+static void fp_boundaries(diy_fp_t v, diy_fp_t * minus, diy_fp_t * plus)
+{
+    diy_fp_t pl = { (v.f << 1) + 1, v.e - 1 };
+    while (!(pl.f & (DP_HIDDEN_BIT << 1))) {
+        pl.f <<= 1;
+        pl.e--;
+    }
+    pl.f <<= 64 - DP_SIGNIFICAND_SIZE - 2;
+    pl.e -= 64 - DP_SIGNIFICAND_SIZE - 2;
+
+    diy_fp_t mi = v.f == DP_HIDDEN_BIT ? (diy_fp_t) { (v.f << 2) - 1, v.e - 2 } : (diy_fp_t) { (v.f << 1) - 1, v.e - 1 };
+    mi.f <<= mi.e - pl.e;
+    mi.e = pl.e;
+
+    *plus = pl;
+    *minus = mi;
+}
+
+///< Returns cached 10^-k, such that the product of it and a number with binary exponent `e` has exponent in [-60, -32]
+static diy_fp_t cached_power(int e, int * k)
+{
+    double dk = (-61 - e) * 0.30102999566398114 + 347; // log10(2)
+    int ik = (int) dk;
+    if (dk - ik > 0.0) {
+        ik++;
+    }
+    unsigned index = (unsigned) ((ik >> 3) + 1);
+    *k = -(-348 + (int) (index << 3));
+    return (diy_fp_t) { cached_powers_f[index], cached_powers_e[index] };
+}
+
+static void grisu_round(char * buffer, int length, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w)
+{
+    while (rest < wp_w && delta - rest >= ten_kappa
+        && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)
+    ) {
+        buffer[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static int count_digits(uint32_t n)
+{
+    int digits = 1;
+    while (digits < 10 && n >= powers_of_10[digits]) {
+        ++digits;
+    }
+    return digits;
+}
+
+static void digit_gen(diy_fp_t w, diy_fp_t mp, uint64_t delta, char * buffer, int * length, int * k)
+{
+    const diy_fp_t one = { 1ull << -mp.e, mp.e };
+    const diy_fp_t wp_w = { mp.f - w.f, mp.e };
+    uint32_t p1 = (uint32_t) (mp.f >> -one.e);
+    uint64_t p2 = mp.f & (one.f - 1);
+    int kappa = count_digits(p1);
+    *length = 0;
+
+    while (kappa > 0) {
+        uint32_t d = (uint32_t) (p1 / powers_of_10[kappa - 1]);
+        p1 %= (uint32_t) powers_of_10[kappa - 1];
+        if (d || *length) {
+            buffer[(*length)++] = (char) ('0' + d);
+        }
+        kappa--;
+        uint64_t rest = ((uint64_t) p1 << -one.e) + p2;
+        if (rest <= delta) {
+            *k += kappa;
+            grisu_round(buffer, *length, delta, rest, powers_of_10[kappa] << -one.e, wp_w.f);
+            return;
+        }
+    }
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        char d = (char) (p2 >> -one.e);
+        if (d || *length) {
+            buffer[(*length)++] = (char) ('0' + d);
+        }
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < delta) {
+            *k += kappa;
+            int index = -kappa;
+            grisu_round(buffer, *length, delta, p2, one.f, wp_w.f * (index < 20 ? powers_of_10[index] : 0));
+            return;
+        }
+    }
+}
+
+///< Generates the shortest digits of a positive double. The value is `digits * 10^k`.
+static int grisu2(uint64_t bits, char * buffer, int * k)
+{
+    int biased_e = (int) ((bits & DP_EXPONENT_MASK) >> DP_SIGNIFICAND_SIZE);
+    uint64_t significand = bits & DP_SIGNIFICAND_MASK;
+    diy_fp_t v = biased_e != 0
+        ? (diy_fp_t) { significand + DP_HIDDEN_BIT, biased_e - DP_EXPONENT_BIAS }
+        : (diy_fp_t) { significand, 1 - DP_EXPONENT_BIAS };
+
+    diy_fp_t w_m, w_p;
+    fp_boundaries(v, &w_m, &w_p);
+
+    diy_fp_t c_mk = cached_power(w_p.e, k);
+    diy_fp_t w  = fp_multiply(fp_normalize(v), c_mk);
+    diy_fp_t wp = fp_multiply(w_p, c_mk);
+    diy_fp_t wm = fp_multiply(w_m, c_mk);
+    wm.f++;
+    wp.f--;
+
+    int length;
+    digit_gen(w, wp, wp.f - wm.f, buffer, &length, k);
+    return length;
+}
+
+static int format_exponent(int k, char * buffer)
+{
+    char * ptr = buffer;
+    if (k < 0) {
+        *ptr++ = '-';
+        k = -k;
+    }
+    char digits[4];
+    char * end = digits + sizeof(digits);
+    char * first = format_uint(end, (uint64_t) k);
+    while (first < end) {
+        *ptr++ = *first++;
+    }
+    return ptr - buffer;
+}
+
+///< Moves `length` characters from `src` to `dst` that is after `src`
+static void move_right(char * dst, const char * src, int length)
+{
+    while (length-- > 0) {
+        dst[length] = src[length];
+    }
+}
+
+/**
+ * \brief Places the decimal point and the exponent.
+ *
+ * \param buffer The digits
+ * \param length Number of digits
+ * \param k      Decimal exponent of the number
+ *
+ * \return The length of the formatted number
+ */
+static int prettify(char * buffer, int length, int k)
+{
+    const int kk = length + k; // 10^(kk-1) <= v < 10^kk
+
+    if (0 <= k && kk <= 21) {
+        // 1234e7 -> 12340000000
+        for (int i = length; i < kk; i++) {
+            buffer[i] = '0';
+        }
+        return kk;
+    }
+    if (0 < kk && kk <= 21) {
+        // 1234e-2 -> 12.34
+        move_right(buffer + kk + 1, buffer + kk, length - kk);
+        buffer[kk] = '.';
+        return length + 1;
+    }
+    if (-6 < kk && kk <= 0) {
+        // 1234e-6 -> 0.001234
+        const int offset = 2 - kk;
+        move_right(buffer + offset, buffer, length);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        for (int i = 2; i < offset; i++) {
+            buffer[i] = '0';
+        }
+        return length + offset;
+    }
+    if (length == 1) {
+        // 1e30
+        buffer[1] = 'e';
+        return 2 + format_exponent(kk - 1, buffer + 2);
+    }
+    // 1234e30 -> 1.234e33
+    move_right(buffer + 2, buffer + 1, length - 1);
+    buffer[1] = '.';
+    buffer[length + 1] = 'e';
+    return length + 2 + format_exponent(kk - 1, buffer + length + 2);
+}
+
+uint8_t jspp_write_double(jspp_writer_t * writer, double value)
+{
+    union {
+        double   d;
+        uint64_t u;
+    } bits = { value };
+
+    if ((bits.u & DP_EXPONENT_MASK) == DP_EXPONENT_MASK) {
+        // NaN or infinity
+        return write_value(writer, JSON_NULL, "null", 4);
+    }
+
+    char buf[32];
+    char * ptr = buf;
+    if (bits.u >> 63) {
+        *ptr++ = '-';
+        bits.u &= ~(1ull << 63);
+    }
+    if (bits.u == 0) {
+        *ptr++ = '0';
+    } else {
+        int k;
+        int length = grisu2(bits.u, ptr, &k);
+        ptr += prettify(ptr, length, k);
+    }
+    return write_value(writer, JSON_FLOATING_POINT, buf, ptr - buf);
+}
+
+static inline int needs_escape(char c)
+{
+    return c == '"' || c == '\\' || (uint8_t) c < 0x20;
+}
+
+///< Returns the pointer to the first character that needs to be escaped or the end of the text
+static const char * find_escape(const char * text, const char * end)
+{
+    while (end - text >= (long) SWAR_SIZE) {
+        swar_t word = swar_load(text);
+        swar_t mask = swar_equal(word, '"') | swar_equal(word, '\\') | swar_less(word, 0x20);
+        if (mask) {
+            return text + swar_first(mask);
+        }
+        text += SWAR_SIZE;
+    }
+    while (text < end && !needs_escape(*text)) {
+        ++text;
+    }
+    return text;
+}
+
+static uint8_t put_escaped(jspp_writer_t * writer, const char * text, uint16_t text_len)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+    const char * const end = text + text_len;
+
+    if (put_char(writer, '"') != WRITE_OK) {
+        return JSON_TOO_DEEP;
+    }
+    while (text < end) {
+        const char * run = text;
+        text = find_escape(text, end);
+        if (put(writer, run, text - run) != WRITE_OK) {
+            return JSON_TOO_DEEP;
+        }
+        if (text == end) {
+            break;
+        }
+        char esc[6] = { '\\', *text, 0, 0, 0, 0 };
+        uint16_t esc_len = 2;
+        switch (*text) {
+            case '\b': esc[1] = 'b'; break;
+            case '\f': esc[1] = 'f'; break;
+            case '\n': esc[1] = 'n'; break;
+            case '\r': esc[1] = 'r'; break;
+            case '\t': esc[1] = 't'; break;
+            case '"':
+            case '\\': break;
+            default: {
+                esc[1] = 'u';
+                esc[2] = '0';
+                esc[3] = '0';
+                esc[4] = hex_digits[(uint8_t) *text >> 4];
+                esc[5] = hex_digits[*text & 0xf];
+                esc_len = 6;
+            }
+        }
+        if (put(writer, esc, esc_len) != WRITE_OK) {
+            return JSON_TOO_DEEP;
+        }
+        ++text;
+    }
+    return put_char(writer, '"');
+}
+
+uint8_t jspp_write_string(jspp_writer_t * writer, const char * text, uint16_t text_len)
+{
+    uint8_t rc = begin_value(writer);
+    if (rc != WRITE_OK) {
+        return rc;
+    }
+    return put_escaped(writer, text, text_len) == WRITE_OK ? JSON_STRING : JSON_TOO_DEEP;
+}
+
+///< Writes a separator before the member name and checks that the name can be written at this point
+static uint8_t begin_member_name(jspp_writer_t * writer)
+{
+    uint8_t flags = writer->stack[writer->level];
+    if (!(flags & W_OBJECT) || (flags & (W_NAME | W_PARTIAL))) {
+        return JSON_INVALID;
+    }
+    if ((flags & W_NOT_EMPTY) && put_char(writer, ',') != WRITE_OK) {
+        return JSON_TOO_DEEP;
+    }
+    return WRITE_OK;
+}
+
+uint8_t jspp_write_member_name(jspp_writer_t * writer, const char * text, uint16_t text_len)
+{
+    uint8_t rc = begin_member_name(writer);
+    if (rc != WRITE_OK) {
+        return rc;
+    }
+    if (put_escaped(writer, text, text_len) != WRITE_OK || put_char(writer, ':') != WRITE_OK) {
+        return JSON_TOO_DEEP;
+    }
+    writer->stack[writer->level] |= W_NAME | W_NOT_EMPTY;
+    return JSON_MEMBER_NAME;
+}
+
+///< Writes the text of a token that might be split in several parts
+static uint8_t write_parts(jspp_writer_t * writer, uint8_t token, const char * text, uint16_t text_len)
+{
+    uint8_t * flags = &writer->stack[writer->level];
+    int is_name = token == JSON_MEMBER_NAME || token == JSON_MEMBER_NAME_PART;
+    int is_string = is_name || token == JSON_STRING || token == JSON_STRING_PART;
+    int is_part = token == JSON_MEMBER_NAME_PART || token == JSON_STRING_PART || token == JSON_NUMBER_PART;
+
+    if (!(*flags & W_PARTIAL)) {
+        uint8_t rc = is_name ? begin_member_name(writer) : begin_value(writer);
+        if (rc != WRITE_OK) {
+            return rc;
+        }
+        if (is_string && put_char(writer, '"') != WRITE_OK) {
+            return JSON_TOO_DEEP;
+        }
+        *flags |= W_PARTIAL;
+    }
+    if (put(writer, text, text_len) != WRITE_OK) {
+        return JSON_TOO_DEEP;
+    }
+    if (!is_part) {
+        if (is_string && put_char(writer, '"') != WRITE_OK) {
+            return JSON_TOO_DEEP;
+        }
+        if (is_name && put_char(writer, ':') != WRITE_OK) {
+            return JSON_TOO_DEEP;
+        }
+        *flags &= ~W_PARTIAL;
+        if (is_name) {
+            *flags |= W_NAME | W_NOT_EMPTY;
+        }
+    }
+    return token;
+}
+
+uint8_t jspp_write_raw(jspp_writer_t * writer, uint8_t token, const char * text, uint16_t text_len)
+{
+    switch (token) {
+        case JSON_OBJECT_BEGIN:     return jspp_write_object_begin(writer);
+        case JSON_OBJECT_END:       return jspp_write_object_end(writer);
+        case JSON_ARRAY_BEGIN:      return jspp_write_array_begin(writer);
+        case JSON_ARRAY_END:        return jspp_write_array_end(writer);
+        case JSON_NULL:             return jspp_write_null(writer);
+        case JSON_TRUE:             return jspp_write_bool(writer, 1);
+        case JSON_FALSE:            return jspp_write_bool(writer, 0);
+        case JSON_MEMBER_NAME_PART:
+        case JSON_MEMBER_NAME:
+        case JSON_STRING_PART:
+        case JSON_STRING:
+        case JSON_NUMBER_PART:
+        case JSON_INTEGER:
+        case JSON_DECIMAL:
+        case JSON_FLOATING_POINT:   return write_parts(writer, token, text, text_len);
+    }
+    return JSON_INVALID;
+}
@@ -0,0 +1,111 @@
+#ifndef __JSPP_WRITER_H
+#define __JSPP_WRITER_H
+
+#include "jspp.h"
+
+/**
+ * \brief Writer output callback.
+ *
+ * \param data       Pointer to the JSON text
+ * \param size       The size of the text
+ * \param flush_data The data pointer that was passed to `jspp_writer_init`
+ */
+typedef void (*jspp_flush_t)(const char * data, uint16_t size, void * flush_data);
+
+typedef struct _json_writer {
+    char *          buffer;         ///< Caller provided output buffer
+    uint16_t        buffer_size;
+    uint16_t        length;         ///< Number of bytes in the buffer
+    jspp_flush_t    flush;
+    void *          flush_data;
+    uint8_t         level;          ///< Number of open objects and arrays
+    uint8_t         stack[JSON_MAX_STACK];
+} jspp_writer_t;
+
+/**
+ * \brief Initializes the writer.
+ *
+ * \param writer     A pointer to the writer struct allocated by the caller
+ * \param buffer     Output buffer
+ * \param size       The size of the output buffer
+ * \param flush      The function that is called when the buffer is full and when `jspp_write_flush`
+ *                   is called. It might be NULL if the entire JSON is expected to fit into the buffer.
+ * \param flush_data The pointer that is passed to the `flush` callback
+ *
+ * The writer tracks objects and arrays it writes and inserts commas and colons where they are needed.
+ * Top level values are separated by new lines, so the writer can also be used to produce NDJSON.
+ */
+void jspp_writer_init(jspp_writer_t * writer, char * buffer, uint16_t size, jspp_flush_t flush, void * flush_data);
+
+/**
+ * \brief Passes the buffered JSON text to the flush callback.
+ *
+ * \param writer A pointer to the writer struct
+ *
+ * \return `JSON_END` when all the open objects and arrays have been closed or `JSON_CONTINUE` otherwise.
+ */
+uint8_t jspp_write_flush(jspp_writer_t * writer);
+
+// All the functions below return the ID of the token they have written or:
+// - `JSON_INVALID` when the token cannot be written at this point. For example, when the
+//   member value is written before the member name or the object is closed by `]`.
+// - `JSON_TOO_DEEP` when nesting exceeds `JSON_MAX_STACK` levels or when the buffer is full and
+//   there is no flush callback to empty it.
+
+uint8_t jspp_write_object_begin(jspp_writer_t * writer);
+uint8_t jspp_write_object_end(jspp_writer_t * writer);
+uint8_t jspp_write_array_begin(jspp_writer_t * writer);
+uint8_t jspp_write_array_end(jspp_writer_t * writer);
+uint8_t jspp_write_null(jspp_writer_t * writer);
+uint8_t jspp_write_bool(jspp_writer_t * writer, int value);
+
+/**
+ * \brief Writes an integer.
+ */
+uint8_t jspp_write_integer(jspp_writer_t * writer, int64_t value);
+
+/**
+ * \brief Writes a floating point number.
+ *
+ * The number is written with the fewest digits that are still converted back to the same double
+ * (Grisu2 - which finds the shortest representation for more than 99% of doubles and otherwise
+ * produces one that is a digit or two longer). NaN and infinities, which JSON cannot represent,
+ * are written as `null`.
+ */
+uint8_t jspp_write_double(jspp_writer_t * writer, double value);
+
+/**
+ * \brief Writes a string.
+ *
+ * \param writer     A pointer to the writer struct
+ * \param text       The string text (UTF-8)
+ * \param text_len   The length of the text
+ *
+ * The text is escaped as needed.
+ */
+uint8_t jspp_write_string(jspp_writer_t * writer, const char * text, uint16_t text_len);
+
+/**
+ * \brief Writes an object member name.
+ *
+ * The text is escaped like the text of `jspp_write_string`.
+ */
+uint8_t jspp_write_member_name(jspp_writer_t * writer, const char * text, uint16_t text_len);
+
+/**
+ * \brief Writes a token which text has been returned by the parser.
+ *
+ * \param writer     A pointer to the writer struct
+ * \param token      The token ID returned by the parser
+ * \param text       The token text as it is returned by `jspp_text`
+ * \param text_len   The length of the text
+ *
+ * The text is copied as is, i.e. strings and member names are expected to be already escaped.
+ * Tokens that are returned in parts (`JSON_MEMBER_NAME_PART`, `JSON_STRING_PART`, `JSON_NUMBER_PART`)
+ * are written in parts too - the writer expects the next part or the final token of the same kind
+ * after them. Literals are written in their canonical form and the text of the object and array
+ * tokens is ignored.
+ */
+uint8_t jspp_write_raw(jspp_writer_t * writer, uint8_t token, const char * text, uint16_t text_len);
+
+#endif
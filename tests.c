@@ -1,7 +1,19 @@
 #include "test.h"
 #include "jspp.h"
+#include "jspp_conv.h"
+#include "jspp_bind.h"
+#include "jspp_tape.h"
+#include "jspp_writer.h"
+#include "jspp_filter.h"
+#include "jspp_transcode.h"
+#include "jspp_pipeline.h"
+#include "jspp_batch.h"
+#include "jspp_index.h"
+#include "jspp_select.h"
+#include "jspp_base64.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #define check_text(v) \
     text = jspp_text(&parser, &length); \
@@ -76,6 +88,7 @@ static int parse_invalid_elements()
     check(JSON_INVALID == jspp_start(&parser, " False ", 7));
     check(JSON_INVALID == jspp_start(&parser, " faLse ", 7));
     check(JSON_INVALID == jspp_start(&parser, " falsE ", 7));
+    check(JSON_INVALID == jspp_next(&parser));
 
     return 0;
 }
@@ -383,6 +396,71 @@ static int parse_split_object()
     return 0;
 }
 
+static int parse_long_runs()
+{
+    // long whitespace, string and digit runs are scanned a word at a time
+    const char json[] = "[\n                \"The quick brown fox\\\" jumps\\\\\",\t\r\n 12345678901234567890,"
+        " 3.14159265358979323846, true , false,null,\"\",\"0123456789abcdef\"\n\n\n\n\n\n\n\n\n]";
+    const uint8_t tokens[] = {
+        JSON_ARRAY_BEGIN, JSON_STRING, JSON_INTEGER, JSON_DECIMAL, JSON_TRUE, JSON_FALSE, JSON_NULL,
+        JSON_STRING, JSON_STRING, JSON_ARRAY_END, JSON_END
+    };
+    const char * texts[] = {
+        "[", "The quick brown fox\\\" jumps\\\\", "12345678901234567890", "3.14159265358979323846",
+        "true", "false", "null", "", "0123456789abcdef", "]"
+    };
+    jspp_t parser;
+    const char * text;
+    uint16_t length;
+
+    // every split must produce the same tokens
+    for (uint16_t split = 0; split < sizeof(json); split++) {
+        char token_text[64];
+        uint16_t token_length = 0;
+        uint8_t i = 0;
+        uint8_t token = jspp_start(&parser, json, split);
+        for (;;) {
+            if (token == JSON_CONTINUE) {
+                token = jspp_continue(&parser, json + split, sizeof(json) - 1 - split);
+                continue;
+            }
+            text = jspp_text(&parser, &length);
+            if (token == JSON_STRING_PART || token == JSON_NUMBER_PART) {
+                memcpy(token_text + token_length, text, length);
+                token_length += length;
+                token = jspp_next(&parser);
+                continue;
+            }
+            check(token == tokens[i]);
+            if (token == JSON_END) {
+                break;
+            }
+            if (token < JSON_NULL || JSON_FALSE < token) {
+                // literals that are split between fragments only report the last part of their text
+                memcpy(token_text + token_length, text, length);
+                token_length += length;
+                check(token_length == strlen(texts[i]));
+                check(strncmp(token_text, texts[i], token_length) == 0);
+            }
+            token_length = 0;
+            ++i;
+            token = jspp_next(&parser);
+        }
+    }
+
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, "[                  \x01 ]", 22));
+    check(JSON_INVALID == jspp_next(&parser));
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, "[                  ! ]", 22));
+    check(JSON_INVALID == jspp_next(&parser));
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, "[12345678901234567x]", 20));
+    check(JSON_INTEGER == jspp_next(&parser));
+    check(JSON_INVALID == jspp_next(&parser));
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, "[nulx,truu,falze]", 17));
+    check(JSON_INVALID == jspp_next(&parser));
+
+    return 0;
+}
+
 static int skip_elements()
 {
     jspp_t parser;
@@ -530,6 +608,1380 @@ static int skip_current()
     return 0;
 }
 
+///< Checks that the text is converted to the same double as `strtod` converts it to
+static int check_double(const char * text)
+{
+    double value;
+    double expected = strtod(text, NULL);
+    check(jspp_scan_double(text, strlen(text), &value) == strlen(text));
+    check(memcmp(&value, &expected, sizeof(value)) == 0);
+    return 0;
+}
+
+static int convert_doubles()
+{
+    static const char * const numbers[] = {
+        "944.1397883359831", "784.28057641852854", "4.77655640221698e+99", "-122.41941550000001",
+        "9007199254740993", "1e23", "8.98846567431158e307", "1.7976931348623157e308", "1.7976931348623159e308",
+        "2.2250738585072011e-308", "2.2250738585072012e-308", "4.9406564584124654e-324", "2.4703282292062327e-324",
+        "2.4703282292062328e-324", "1e-400", "1e400", "0.000000000000000000000000000001", "-0.0",
+        // halfway between 2^53 and the next double, with and without the digits that break the tie
+        "9007199254740993.0000000000000000000000000000000000000000000000000000000000000000000000000000",
+        "9007199254740993.0000000000000000000000000000000000000000000000000000000000000000000000000001",
+        NULL
+    };
+    int rc;
+    for (int i = 0; numbers[i]; i++) {
+        if ((rc = check_double(numbers[i]))) {
+            return rc;
+        }
+    }
+    // 15 to 17 significant digits - the output of JSON encoders that print the shortest round trip form
+    uint64_t x = 88172645463325252ull;
+    char text[32];
+    for (int i = 0; i < 100000; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        double d;
+        memcpy(&d, &x, sizeof(d));
+        if (d != d || d - d != 0) {
+            continue;
+        }
+        snprintf(text, sizeof(text), "%.*g", 15 + i % 3, d);
+        if ((rc = check_double(text))) {
+            return rc;
+        }
+    }
+    return 0;
+}
+
+typedef struct _bind_point {
+    int32_t x;
+    int32_t y;
+} bind_point_t;
+
+typedef struct _bind_shape {
+    char            name[8];
+    uint8_t         visible;
+    double          scale;
+    int64_t         id;
+    bind_point_t    origin;
+    bind_point_t    points[3];
+    uint16_t        num_points;
+    int32_t         tags[2];
+    uint16_t        num_tags;
+} bind_shape_t;
+
+static const jspp_bind_field_t bind_point_fields[] = {
+    JSPP_BIND_FIELD(bind_point_t, x, JSPP_BIND_INT32),
+    JSPP_BIND_FIELD(bind_point_t, y, JSPP_BIND_INT32),
+    JSPP_BIND_END
+};
+
+static const jspp_bind_field_t bind_shape_fields[] = {
+    JSPP_BIND_STRING_FIELD(bind_shape_t, name),
+    JSPP_BIND_FIELD(bind_shape_t, visible, JSPP_BIND_BOOL),
+    JSPP_BIND_FIELD(bind_shape_t, scale, JSPP_BIND_DOUBLE),
+    JSPP_BIND_FIELD(bind_shape_t, id, JSPP_BIND_INT64),
+    JSPP_BIND_OBJECT_FIELD(bind_shape_t, origin, bind_point_fields),
+    JSPP_BIND_ARRAY_FIELD(bind_shape_t, points, num_points, JSPP_BIND_OBJECT, bind_point_fields),
+    JSPP_BIND_ARRAY_FIELD(bind_shape_t, tags, num_tags, JSPP_BIND_INT32, NULL),
+    JSPP_BIND_END
+};
+
+static int bind_struct()
+{
+    const char json[] = "{ \"kind\": { \"a\": [1, {\"b\": null}] }, \"name\": \"triangle\", \"visible\": true,"
+        " \"scale\": 1.25e1, \"id\": 12345678901234, \"origin\": { \"y\": -7, \"z\": 3, \"x\": 5 },"
+        " \"points\": [ {\"x\": 1, \"y\": 2}, {\"x\": 3, \"y\": 4}, {\"x\": 5, \"y\": 6}, {\"x\": 7, \"y\": 8} ],"
+        " \"tags\": [ 10, \"unexpected\", null, 3000000000, 20 ], \"visible_too_long_to_be_collected_in_the_side_buffer\": false }";
+
+    // Parse the same JSON split into fragments of every possible size
+    for (uint16_t fragment_size = 1; fragment_size <= sizeof(json) - 1; fragment_size++) {
+        bind_shape_t shape;
+        memset(&shape, 0, sizeof(shape));
+
+        jspp_bind_t binding;
+        jspp_bind_init(&binding, bind_shape_fields, &shape);
+
+        uint8_t token = JSON_CONTINUE;
+        for (uint16_t pos = 0; pos < sizeof(json) - 1 && token == JSON_CONTINUE; pos += fragment_size) {
+            uint16_t size = sizeof(json) - 1 - pos;
+            token = jspp_bind_feed(&binding, json + pos, size < fragment_size ? size : fragment_size);
+        }
+        check(token == JSON_END);
+        check(strcmp(shape.name, "triangl") == 0);
+        check(shape.visible == 1);
+        check(shape.scale == 12.5);
+        check(shape.id == 12345678901234);
+        check(shape.origin.x == 5 && shape.origin.y == -7);
+        check(shape.num_points == 3);
+        check(shape.points[0].x == 1 && shape.points[0].y == 2);
+        check(shape.points[2].x == 5 && shape.points[2].y == 6);
+        // the elements that cannot be stored are not counted
+        check(shape.num_tags == 2);
+        check(shape.tags[0] == 10 && shape.tags[1] == 20);
+    }
+
+    return 0;
+}
+
+#define check_cursor_text(v) \
+    text = jspp_cursor_text(&cursor, json, &tape_text_length); \
+    check(tape_text_length == sizeof(v) - 1); \
+    check(strncmp(text, v, tape_text_length) == 0)
+
+static int record_tape()
+{
+    const char json[] = "{ \"skip\": [ 1, { \"a\": [] }, null ], \"name\": \"a long string\", \"flag\": false, \"rate\": -12.5e3 }";
+    jspp_tape_entry_t arena[20];
+    jspp_tape_t tape;
+    const char * text;
+    uint32_t tape_text_length;
+
+    jspp_tape_init(&tape, arena, sizeof(arena) / sizeof(arena[0]));
+    for (uint16_t fragment_size = 1; fragment_size <= sizeof(json) - 1; fragment_size++) {
+        jspp_tape_reset(&tape);
+        uint8_t token = JSON_CONTINUE;
+        for (uint16_t pos = 0; pos < sizeof(json) - 1 && token == JSON_CONTINUE; pos += fragment_size) {
+            uint16_t size = sizeof(json) - 1 - pos;
+            token = jspp_tape_feed(&tape, json + pos, size < fragment_size ? size : fragment_size);
+        }
+        check(token == JSON_END);
+        check(tape.size == 18);
+
+        jspp_cursor_t cursor = jspp_tape_cursor(&tape);
+        check(JSON_OBJECT_BEGIN == jspp_cursor_token(&cursor));
+        check(JSON_MEMBER_NAME == jspp_cursor_next(&cursor));
+        check_cursor_text("skip");
+        check(JSON_MEMBER_NAME == jspp_cursor_skip(&cursor));
+        check_cursor_text("name");
+        check(JSON_STRING == jspp_cursor_next(&cursor));
+        check_cursor_text("a long string");
+        check(JSON_MEMBER_NAME == jspp_cursor_next(&cursor));
+        check(JSON_FALSE == jspp_cursor_next(&cursor));
+        check_cursor_text("false");
+        check(JSON_MEMBER_NAME == jspp_cursor_next(&cursor));
+        check(JSON_FLOATING_POINT == jspp_cursor_next(&cursor));
+        check_cursor_text("-12.5e3");
+        check(JSON_OBJECT_END == jspp_cursor_next(&cursor));
+        check(JSON_END == jspp_cursor_next(&cursor));
+
+        // go back and look into the skipped array
+        cursor = jspp_tape_cursor(&tape);
+        check(JSON_MEMBER_NAME == jspp_cursor_next(&cursor));
+        check(JSON_ARRAY_BEGIN == jspp_cursor_next(&cursor));
+        check(JSON_INTEGER == jspp_cursor_next(&cursor));
+        check(JSON_OBJECT_BEGIN == jspp_cursor_next(&cursor));
+        check(JSON_NULL == jspp_cursor_skip(&cursor));
+        check_cursor_text("null");
+        check(JSON_ARRAY_END == jspp_cursor_next(&cursor));
+        check(JSON_ARRAY_END == jspp_cursor_skip(&cursor));
+    }
+
+    // the arena is too small for this JSON
+    jspp_tape_init(&tape, arena, 10);
+    check(JSPP_TAPE_FULL == jspp_tape_feed(&tape, json, sizeof(json) - 1));
+    check(JSPP_TAPE_FULL == jspp_tape_feed(&tape, json, sizeof(json) - 1));
+
+    // the document grows past the 4 GiB that entries can address
+    jspp_tape_init(&tape, arena, sizeof(arena) / sizeof(arena[0]));
+    check(JSON_CONTINUE == jspp_tape_feed(&tape, json, 10));
+    tape.offset = 0xffffffff - 20;
+    check(JSON_CONTINUE == jspp_tape_feed(&tape, json + 10, 20));
+    check(JSPP_TAPE_FULL == jspp_tape_feed(&tape, json + 30, 1));
+    jspp_tape_reset(&tape);
+    check(JSON_END == jspp_tape_feed(&tape, json, sizeof(json) - 1));
+
+    return 0;
+}
+
+static int find_member()
+{
+    jspp_t parser;
+    jspp_search_t search;
+    const char * text;
+    uint16_t length;
+
+    const char json1[] = "{ \"status\": \"ok\", \"response\": { \"a\": [1, {\"x\": 0}], \"x\": 42 }, \"rc\": 7, \"last\": true }";
+
+    check(JSON_OBJECT_BEGIN == jspp_start(&parser, json1, sizeof(json1) - 1));
+    check(JSON_OBJECT_BEGIN == jspp_find_member(&parser, &search, "response", 8));
+    check(JSON_INTEGER == jspp_find_member(&parser, &search, "x", 1));
+    check_text("42");
+    check(JSON_OBJECT_END == jspp_find_member(&parser, &search, "x", 1));
+    check(JSON_INTEGER == jspp_find_member(&parser, &search, "rc", 2));
+    check_text("7");
+    check(JSON_OBJECT_END == jspp_find_member(&parser, &search, "status", 6));
+    check(JSON_END == jspp_next(&parser));
+
+    // the current member name is checked first
+    check(JSON_OBJECT_BEGIN == jspp_start(&parser, json1, sizeof(json1) - 1));
+    check(JSON_MEMBER_NAME == jspp_next(&parser));
+    check(JSON_STRING == jspp_find_member(&parser, &search, "status", 6));
+    check_text("ok");
+
+    // the search is interrupted in the skipped value, in the matching name and between the name and the value
+    const char json21[] = "{ \"status\": \"ok\", \"response\": { \"a\": [1, {\"x";
+    const char json22[] = "\": 0}], \"x\": 42 }, \"r";
+    const char json23[] = "c\": ";
+    const char json24[] = "7, \"last\": true }";
+
+    check(JSON_OBJECT_BEGIN == jspp_start(&parser, json21, sizeof(json21) - 1));
+    check(JSON_CONTINUE == jspp_find_member(&parser, &search, "rc", 2));
+    check(JSON_CONTINUE == jspp_continue(&parser, json22, sizeof(json22) - 1));
+    check(JSON_CONTINUE == jspp_continue(&parser, json23, sizeof(json23) - 1));
+    check(JSON_INTEGER == jspp_continue(&parser, json24, sizeof(json24) - 1));
+    check_text("7");
+    check(JSON_TRUE == jspp_find_member(&parser, &search, "last", 4));
+
+    // interrupted in the name that does not match
+    const char json31[] = "{ \"status\": \"ok\", \"re";
+    const char json32[] = "sponse\": { \"x\": 42 }, \"rc\": 7 }";
+
+    check(JSON_OBJECT_BEGIN == jspp_start(&parser, json31, sizeof(json31) - 1));
+    check(JSON_CONTINUE == jspp_find_member(&parser, &search, "rc", 2));
+    check(JSON_INTEGER == jspp_continue(&parser, json32, sizeof(json32) - 1));
+    check_text("7");
+
+    // all possible fragment boundaries
+    for (uint16_t fragment_size = 1; fragment_size <= sizeof(json1) - 1; fragment_size++) {
+        uint16_t pos = 0;
+        uint8_t token = jspp_start(&parser, json1, fragment_size);
+        check(JSON_OBJECT_BEGIN == token);
+        token = jspp_find_member(&parser, &search, "last", 4);
+        while (token == JSON_CONTINUE) {
+            pos += fragment_size;
+            check(pos < sizeof(json1) - 1);
+            uint16_t size = sizeof(json1) - 1 - pos;
+            token = jspp_continue(&parser, json1 + pos, size < fragment_size ? size : fragment_size);
+        }
+        check(JSON_TRUE == token);
+    }
+
+    return 0;
+}
+
+static int seek_array_elements()
+{
+    jspp_t parser;
+    jspp_search_t search;
+    const char * text;
+    uint16_t length;
+
+    const char json1[] = "[ 0, \"1, [\\\"]\", { \"2\": [2, 2] }, [3, [3]], 4.4, null, \"6\" ]";
+
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, json1, sizeof(json1) - 1));
+    check(JSON_INTEGER == jspp_seek_index(&parser, &search, 0));
+    check_text("0");
+    check(JSON_DECIMAL == jspp_seek_index(&parser, &search, 3));
+    check_text("4.4");
+    check(JSON_STRING == jspp_seek_index(&parser, &search, 1));
+    check_text("6");
+    check(JSON_ARRAY_END == jspp_seek_index(&parser, &search, 0));
+    check(JSON_END == jspp_next(&parser));
+
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, json1, sizeof(json1) - 1));
+    check(JSON_ARRAY_END == jspp_seek_index(&parser, &search, 10));
+    check(JSON_END == jspp_next(&parser));
+
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, json1, sizeof(json1) - 1));
+    check(JSON_INTEGER == jspp_next(&parser));
+    check(JSON_ARRAY_END == jspp_count_elements(&parser, &search));
+    check(6 == jspp_element_count(&search));
+    check(JSON_END == jspp_next(&parser));
+
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, " [ ] ", 5));
+    check(JSON_ARRAY_END == jspp_count_elements(&parser, &search));
+    check(0 == jspp_element_count(&search));
+
+    check(JSON_OBJECT_BEGIN == jspp_start(&parser, "{}", 2));
+    check(JSON_INVALID == jspp_seek_index(&parser, &search, 1));
+
+    // a closing bracket that does not close anything must not be counted as an element
+    const char json2[] = "[1}, 2, 3] ";
+    for (uint16_t fragment_size = 1; fragment_size <= sizeof(json2) - 1; fragment_size++) {
+        uint16_t pos = 0;
+        check(JSON_ARRAY_BEGIN == jspp_start(&parser, json2, fragment_size));
+        uint8_t token = jspp_count_elements(&parser, &search);
+        while (token == JSON_CONTINUE) {
+            pos += fragment_size;
+            check(pos < sizeof(json2) - 1);
+            uint16_t size = sizeof(json2) - 1 - pos;
+            token = jspp_continue(&parser, json2 + pos, size < fragment_size ? size : fragment_size);
+        }
+        check(JSON_INVALID == token);
+        check(JSON_INVALID == jspp_next(&parser));
+    }
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, json2, sizeof(json2) - 1));
+    check(JSON_INVALID == jspp_seek_index(&parser, &search, 2));
+
+    // all possible fragment boundaries
+    for (uint16_t fragment_size = 1; fragment_size <= sizeof(json1) - 1; fragment_size++) {
+        uint16_t pos = 0;
+        check(JSON_ARRAY_BEGIN == jspp_start(&parser, json1, fragment_size));
+        uint8_t token = jspp_seek_index(&parser, &search, 4);
+        while (token == JSON_CONTINUE || token == JSON_NUMBER_PART) {
+            pos += fragment_size;
+            check(pos < sizeof(json1) - 1);
+            uint16_t size = sizeof(json1) - 1 - pos;
+            token = jspp_continue(&parser, json1 + pos, size < fragment_size ? size : fragment_size);
+        }
+        check(JSON_DECIMAL == token);
+
+        token = jspp_count_elements(&parser, &search);
+        while (token == JSON_CONTINUE) {
+            pos += fragment_size;
+            check(pos < sizeof(json1) - 1);
+            uint16_t size = sizeof(json1) - 1 - pos;
+            token = jspp_continue(&parser, json1 + pos, size < fragment_size ? size : fragment_size);
+        }
+        check(JSON_ARRAY_END == token);
+        check(2 == jspp_element_count(&search));
+    }
+
+    return 0;
+}
+
+static int read_number_arrays()
+{
+    jspp_t parser;
+    jspp_search_t search;
+    jspp_number_reader_t reader;
+    double numbers[16];
+    int64_t integers[16];
+
+    static const char json[] = "{\"c\": [[1.5, -2 ,3e2, 0, 123456789012345, 1.234e-6, -0.25], [7, 8, \"x\", 9], [10, 11, 12]], \"n\": 1}";
+    static const double expected_numbers[] = { 1.5, -2, 3e2, 0, 123456789012345, 1.234e-6, -0.25 };
+    static const int64_t expected_integers[] = { 7, 8, 9, 10, 11, 12 };
+
+    // all possible fragment boundaries. The last array is read one integer at a time.
+    for (uint16_t size = 1; size < sizeof(json); size++) {
+        uint32_t num_numbers = 0;
+        uint32_t num_integers = 0;
+        uint8_t arrays = 0;
+        uint8_t reading = 0;
+        uint16_t pos = size;
+        jspp_number_reader_init(&reader);
+        uint8_t token = jspp_start(&parser, json, size);
+        while (token != JSON_END) {
+            check(token != JSON_INVALID);
+            if (token == JSON_CONTINUE) {
+                check(pos < sizeof(json) - 1);
+                uint16_t len = sizeof(json) - 1 - pos < size ? sizeof(json) - 1 - pos : size;
+                token = jspp_continue(&parser, json + pos, len);
+                pos += len;
+                continue;
+            }
+            if (token == JSON_ARRAY_BEGIN) {
+                reading = ++arrays > 1;
+            } else if (token == JSON_ARRAY_END) {
+                reading = 0;
+            }
+            if (reading && (token == JSON_ARRAY_BEGIN || token == JSON_NUMBER_PART || (JSON_INTEGER <= token && token <= JSON_FLOATING_POINT))) {
+                if (arrays == 2) {
+                    num_numbers += jspp_read_number_array(&parser, &reader, numbers + num_numbers, 16 - num_numbers);
+                } else {
+                    num_integers += jspp_read_int64_array(&parser, &reader, integers + num_integers, arrays == 4 ? 1 : 16 - num_integers);
+                }
+                token = parser.token;
+            } else {
+                token = jspp_next(&parser);
+            }
+        }
+        check(num_numbers == sizeof(expected_numbers) / sizeof(expected_numbers[0]));
+        check(memcmp(numbers, expected_numbers, sizeof(expected_numbers)) == 0);
+        check(num_integers == sizeof(expected_integers) / sizeof(expected_integers[0]));
+        check(memcmp(integers, expected_integers, sizeof(expected_integers)) == 0);
+    }
+
+    // stops at the number that is not an integer and at invalid JSON
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, "[1, 2.5]", 8));
+    check(1 == jspp_read_int64_array(&parser, &reader, integers, 16));
+    check(JSON_DECIMAL == parser.token);
+    check(1 == jspp_read_number_array(&parser, &reader, numbers, 16) && numbers[0] == 2.5);
+    check(JSON_ARRAY_END == parser.token);
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, "[1, 2.5.1]", 10));
+    check(1 == jspp_read_number_array(&parser, &reader, numbers, 16));
+    check(JSON_DECIMAL == parser.token);
+    check(1 == jspp_read_number_array(&parser, &reader, numbers, 16));
+    check(JSON_INVALID == parser.token);
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, "[1 2]", 5));
+    check(1 == jspp_read_number_array(&parser, &reader, numbers, 16));
+    check(JSON_INVALID == parser.token);
+
+    // not in an array
+    check(JSON_OBJECT_BEGIN == jspp_start(&parser, "{\"a\": 1}", 8));
+    check(JSON_INTEGER == jspp_find_member(&parser, &search, "a", 1));
+    check(0 == jspp_read_number_array(&parser, &reader, numbers, 16));
+    check(JSON_INTEGER == parser.token);
+
+    // the reader holds a part of the number until the next fragment
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, "[1, 23", 6));
+    check(1 == jspp_read_number_array(&parser, &reader, numbers, 16));
+    check(JSON_CONTINUE == parser.token);
+    check(2 == reader.length);
+    check(JSON_INTEGER == jspp_continue(&parser, "4]", 2));
+    check(1 == jspp_read_number_array(&parser, &reader, numbers, 16) && numbers[0] == 234);
+    check(JSON_ARRAY_END == parser.token);
+
+    // coordinates with 17 significant digits are converted exactly as `strtod` converts them
+    char coordinates[64 * 26];
+    double expected[64];
+    double values[64];
+    uint16_t length = 0;
+    uint64_t x = 88172645463325252ull;
+    for (int i = 0; i < 64; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        double coordinate = (double) (x % 360000000000000000ull) / 1e15 - 180;
+        length += snprintf(coordinates + length, sizeof(coordinates) - length, "%c%.17g", i ? ',' : '[', coordinate);
+        expected[i] = strtod(strrchr(coordinates, i ? ',' : '[') + 1, NULL);
+    }
+    coordinates[length++] = ']';
+    for (uint16_t size = 1; size <= length; size++) {
+        uint32_t count = 0;
+        uint16_t pos = size < length ? size : length;
+        jspp_number_reader_init(&reader);
+        uint8_t token = jspp_start(&parser, coordinates, pos);
+        while (token != JSON_ARRAY_END) {
+            check(token != JSON_INVALID && token != JSON_END);
+            if (token == JSON_CONTINUE) {
+                check(pos < length);
+                uint16_t len = length - pos < size ? length - pos : size;
+                token = jspp_continue(&parser, coordinates + pos, len);
+                pos += len;
+                continue;
+            }
+            count += jspp_read_number_array(&parser, &reader, values + count, 64 - count);
+            token = parser.token;
+        }
+        check(count == 64);
+        check(memcmp(values, expected, sizeof(expected)) == 0);
+    }
+
+    return 0;
+}
+
+static int checkpoint_restore()
+{
+    jspp_t parser;
+    jspp_search_t search;
+    const char * text;
+    uint16_t length;
+    uint8_t checkpoint[JSPP_CHECKPOINT_SIZE];
+    uint16_t checkpoint_size;
+    uint64_t offset;
+
+    const char json[] = "{ \"skip\": [ 1, { \"a\": [] }, null ], \"name\": \"a long string\", \"rate\": -12.5e3 }";
+
+    // save the state after every token and at the end of every fragment, and then restart from it
+    for (uint16_t fragment_size = 1; fragment_size <= sizeof(json) - 1; fragment_size++) {
+        uint16_t pos = 0;
+        uint8_t token = jspp_start(&parser, json, fragment_size);
+        check(JSON_OBJECT_BEGIN == token);
+        do {
+            checkpoint_size = jspp_checkpoint(&parser, checkpoint, sizeof(checkpoint));
+            check(checkpoint_size > 0);
+            check(0 == jspp_checkpoint(&parser, checkpoint, checkpoint_size - 1));
+
+            jspp_t restored;
+            check(JSON_CONTINUE == jspp_restore(&restored, checkpoint, checkpoint_size, &offset));
+            check(offset <= sizeof(json) - 1);
+            // Restored parser does not know the last token, so it cannot skip it. Only test it if the
+            // parser does not need it.
+            if (token != JSON_OBJECT_BEGIN && token != JSON_ARRAY_BEGIN && token != JSON_MEMBER_NAME
+                && token != JSON_NUMBER_PART && token != JSON_STRING_PART && token != JSON_MEMBER_NAME_PART) {
+                // the rest of JSON in one fragment
+                uint8_t restored_token = jspp_continue(&restored, json + offset, sizeof(json) - 1 - offset);
+                while (restored_token != JSON_END) {
+                    check(restored_token != JSON_INVALID && restored_token != JSON_CONTINUE);
+                    restored_token = jspp_next(&restored);
+                }
+            }
+
+            token = jspp_next(&parser);
+            if (token == JSON_CONTINUE || token == JSON_NUMBER_PART || token == JSON_STRING_PART || token == JSON_MEMBER_NAME_PART) {
+                pos += fragment_size;
+                if (pos >= sizeof(json) - 1) break;
+                uint16_t size = sizeof(json) - 1 - pos;
+                token = jspp_continue(&parser, json + pos, size < fragment_size ? size : fragment_size);
+            }
+        } while (token != JSON_END);
+        check(token == JSON_END);
+    }
+
+    // resume skipping
+    check(JSON_OBJECT_BEGIN == jspp_start(&parser, json, 20));
+    check(JSON_CONTINUE == jspp_skip_next(&parser));
+    checkpoint_size = jspp_checkpoint(&parser, checkpoint, sizeof(checkpoint));
+    check(JSON_CONTINUE == jspp_restore(&parser, checkpoint, checkpoint_size, &offset));
+    check(offset == 20);
+    check(JSON_MEMBER_NAME == jspp_continue(&parser, json + offset, sizeof(json) - 1 - offset));
+    check_text("name");
+
+    // state cannot be saved while the parser is looking for a member
+    check(JSON_OBJECT_BEGIN == jspp_start(&parser, json, 20));
+    check(JSON_CONTINUE == jspp_find_member(&parser, &search, "name", 4));
+    check(0 == jspp_checkpoint(&parser, checkpoint, sizeof(checkpoint)));
+    // or while it is scanning an array
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, "[1, 2", 5));
+    check(JSON_CONTINUE == jspp_seek_index(&parser, &search, 5));
+    check(0 == jspp_checkpoint(&parser, checkpoint, sizeof(checkpoint)));
+
+    checkpoint[0] = 0;
+    check(JSON_INVALID == jspp_restore(&parser, checkpoint, checkpoint_size, &offset));
+
+    // damaged states, skip tokens and levels are either rejected or the parser stays on its stack
+    for (int skipping = 1; skipping >= 0; skipping--) {
+        if (skipping) {
+            check(JSON_OBJECT_BEGIN == jspp_start(&parser, json, 20));
+            check(JSON_CONTINUE == jspp_skip_next(&parser));
+        } else {
+            check(JSON_CONTINUE == jspp_start(&parser, json, 0));
+        }
+        checkpoint_size = jspp_checkpoint(&parser, checkpoint, sizeof(checkpoint));
+        check(checkpoint_size > 0);
+        for (uint16_t pos = 9; pos < checkpoint_size; pos++) {
+            uint8_t saved = checkpoint[pos];
+            for (uint16_t value = 0; value < 256; value++) {
+                checkpoint[pos] = (uint8_t) value;
+                if (jspp_restore(&parser, checkpoint, checkpoint_size, &offset) == JSON_CONTINUE) {
+                    check(parser.level < JSON_MAX_STACK && parser.skip_level <= parser.level);
+                    uint8_t token = jspp_continue(&parser, "]}]}]} 1 \"a\": [], ", 18);
+                    for (int n = 0; n < 20 && token > JSON_CONTINUE; n++) {
+                        check(parser.level < JSON_MAX_STACK);
+                        token = jspp_next(&parser);
+                    }
+                }
+            }
+            checkpoint[pos] = saved;
+        }
+    }
+    check(JSON_CONTINUE == jspp_restore(&parser, checkpoint, checkpoint_size, &offset));
+    checkpoint[11] = checkpoint[9] + 1;
+    check(JSON_INVALID == jspp_restore(&parser, checkpoint, checkpoint_size, &offset));
+    checkpoint[11] = 0;
+    checkpoint[10] = JSON_NUMBER_PART;
+    check(JSON_INVALID == jspp_restore(&parser, checkpoint, checkpoint_size, &offset));
+
+    return 0;
+}
+
+typedef struct _output {
+    char     text[256];
+    uint16_t length;
+} output_t;
+
+static void collect_output(const char * data, uint16_t size, void * flush_data)
+{
+    output_t * output = flush_data;
+    memcpy(output->text + output->length, data, size);
+    output->length += size;
+}
+
+typedef struct _capture {
+    output_t     output;
+    const char * first;     ///< Text passed to the sink first
+    int          calls;
+} capture_t;
+
+static void capture_output(const char * data, uint16_t size, void * sink_data)
+{
+    capture_t * capture = sink_data;
+    if (capture->calls++ == 0) {
+        capture->first = data;
+    }
+    collect_output(data, size, &capture->output);
+}
+
+static int capture_elements()
+{
+    const char json[] = "{ \"a\" : { \"x\": [1, \"s\\\"}\", {\"y\": null}] } , \"b\": \"str]\" ,\"c\":-12.5e3, \"d\": true, \"e\": [ ] }";
+    const char expected[] = "{ \"x\": [1, \"s\\\"}\", {\"y\": null}] }|\"str]\"|-12.5e3|true|[ ]|";
+    jspp_t parser;
+    capture_t capture;
+    jspp_capture_t state;
+    uint8_t checkpoint[JSPP_CHECKPOINT_SIZE];
+
+    jspp_capture_init(&state, capture_output, &capture);
+
+    for (uint16_t fragment_size = 1; fragment_size <= sizeof(json) - 1; fragment_size++) {
+        uint16_t pos = 0;
+        int capturing = 0;
+        capture.output.length = 0;
+        uint8_t token = jspp_start(&parser, json, fragment_size);
+        for (;;) {
+            if (token == JSON_CONTINUE) {
+                pos += fragment_size;
+                if (pos >= sizeof(json) - 1) break;
+                uint16_t size = sizeof(json) - 1 - pos;
+                token = jspp_continue(&parser, json + pos, size < fragment_size ? size : fragment_size);
+                continue;
+            }
+            if (capturing) {
+                capture.output.text[capture.output.length++] = '|';
+                capturing = 0;
+            }
+            if (token == JSON_OBJECT_BEGIN || token == JSON_MEMBER_NAME || token == JSON_MEMBER_NAME_PART) {
+                // captures the value of the next member
+                capturing = 1;
+                token = jspp_capture_next(&parser, &state);
+            } else if (token == JSON_OBJECT_END) {
+                token = jspp_next(&parser);
+            } else {
+                break;
+            }
+        }
+        check(token == JSON_END);
+        check(capture.output.length == sizeof(expected) - 1);
+        check(strncmp(capture.output.text, expected, capture.output.length) == 0);
+    }
+
+    // the element in the current fragment is passed to the sink as is
+    capture.output.length = 0;
+    capture.calls = 0;
+    check(JSON_OBJECT_BEGIN == jspp_start(&parser, json, sizeof(json) - 1));
+    check(JSON_MEMBER_NAME == jspp_capture_next(&parser, &state));
+    check(capture.calls == 1);
+    check(capture.first == json + 8);
+    check(capture.output.length == 33);
+
+    // state cannot be saved while the element is being captured
+    check(JSON_OBJECT_BEGIN == jspp_start(&parser, json, 12));
+    check(JSON_CONTINUE == jspp_capture_next(&parser, &state));
+    check(0 == jspp_checkpoint(&parser, checkpoint, sizeof(checkpoint)));
+
+    // nothing to capture
+    capture.calls = 0;
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, "[]", 2));
+    check(JSON_ARRAY_END == jspp_capture_next(&parser, &state));
+    check(capture.calls == 0);
+    check(JSON_END == jspp_next(&parser));
+
+    // invalid element
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, "[{\"a\":[tru]}]", 14));
+    check(JSON_INVALID == jspp_capture_next(&parser, &state));
+    check(capture.calls == 0);
+    check(JSON_ARRAY_BEGIN == jspp_start(&parser, "[{\"a\":[tru]}]", 14));
+    check(JSON_INVALID == jspp_skip_next(&parser));
+
+    return 0;
+}
+
+static int intern_member_names()
+{
+    const char * json[] = {
+        "{\"id\":1,\"name\":\"a\",\"na",
+        "me\":{\"id\":2},\"x\":0,\"y\":[],\"z\":null}"
+    };
+    jspp_intern_entry_t entries[4];
+    char names[16];
+    jspp_intern_t table;
+    jspp_t parser;
+    const char * text;
+    uint16_t length;
+
+    jspp_intern_init(&table, entries, 4, names, sizeof(names));
+    check(JSON_OBJECT_BEGIN == jspp_start(&parser, json[0], strlen(json[0])));
+    jspp_set_intern(&parser, &table);
+    check(JSPP_MEMBER_UNKNOWN == jspp_member_id(&parser));
+
+    check(JSON_MEMBER_NAME == jspp_next(&parser));
+    uint16_t id = jspp_member_id(&parser);
+    check(id < 4);
+    text = jspp_intern_name(&table, id, &length);
+    check(length == 2 && strncmp(text, "id", 2) == 0);
+    check(JSON_INTEGER == jspp_next(&parser));
+    check(JSPP_MEMBER_UNKNOWN == jspp_member_id(&parser));
+
+    check(JSON_MEMBER_NAME == jspp_next(&parser));
+    uint16_t name_id = jspp_member_id(&parser);
+    check(name_id < 4 && name_id != id);
+    check(JSON_STRING == jspp_next(&parser));
+
+    // a split name is interned when it is complete
+    check(JSON_MEMBER_NAME_PART == jspp_next(&parser));
+    check(JSPP_MEMBER_UNKNOWN == jspp_member_id(&parser));
+    check(JSON_CONTINUE == jspp_next(&parser));
+    check(JSON_MEMBER_NAME == jspp_continue(&parser, json[1], strlen(json[1])));
+    check(name_id == jspp_member_id(&parser));
+    check(JSON_OBJECT_BEGIN == jspp_next(&parser));
+    check(JSON_MEMBER_NAME == jspp_next(&parser));
+    check(id == jspp_member_id(&parser));
+    check(JSON_INTEGER == jspp_next(&parser));
+    check(JSON_OBJECT_END == jspp_next(&parser));
+
+    // the table can hold 3 names
+    check(JSON_MEMBER_NAME == jspp_next(&parser));
+    uint16_t x_id = jspp_member_id(&parser);
+    check(x_id < 4 && x_id != id && x_id != name_id);
+    check(JSON_INTEGER == jspp_next(&parser));
+    check(JSON_MEMBER_NAME == jspp_next(&parser));
+    check(JSPP_MEMBER_UNKNOWN == jspp_member_id(&parser));
+    check(JSON_ARRAY_BEGIN == jspp_next(&parser));
+    check(JSON_ARRAY_END == jspp_next(&parser));
+    check(JSON_MEMBER_NAME == jspp_next(&parser));
+    check(JSPP_MEMBER_UNKNOWN == jspp_member_id(&parser));
+    check(JSON_NULL == jspp_next(&parser));
+    check(JSON_OBJECT_END == jspp_next(&parser));
+    check(JSON_END == jspp_next(&parser));
+
+    // IDs are kept for the next document
+    check(JSON_OBJECT_BEGIN == jspp_start(&parser, "{\"x\":{\"name\":0}}", 17));
+    jspp_set_intern(&parser, &table);
+    check(JSON_MEMBER_NAME == jspp_next(&parser));
+    check(x_id == jspp_member_id(&parser));
+    check(JSON_OBJECT_BEGIN == jspp_next(&parser));
+    check(JSON_MEMBER_NAME == jspp_next(&parser));
+    check(name_id == jspp_member_id(&parser));
+
+    check(NULL == jspp_intern_name(&table, JSPP_MEMBER_UNKNOWN, &length));
+
+    return 0;
+}
+
+static int predict_shape()
+{
+    const char json[] =
+        "[{\"id\":1,\"name\":\"a\",\"tags\":{\"id\":\"x\"}},"
+        "{\"id\":2,\"name\":\"tags\",\"tags\":{}},"
+        "{\"id\":3,\"type\":\"b\",\"tags\":[]},"
+        "{\"id\":4,\"type\":\"c\",\"tags\":null}]";
+    const char * member_names[] = { "id", "name", "tags", "id", "name", "tags", "id", "type", "tags", "id", "type", "tags" };
+    jspp_intern_entry_t entries[16];
+    char names[64];
+    jspp_intern_t table;
+    jspp_shape_t shape;
+    jspp_t parser;
+    uint16_t ids[12];
+    uint8_t num_names = 0;
+    const char * text;
+    uint16_t length;
+
+    jspp_intern_init(&table, entries, 16, names, sizeof(names));
+    jspp_shape_init(&shape, 2);
+    uint8_t token = jspp_start(&parser, json, sizeof(json) - 1);
+    jspp_set_intern(&parser, &table);
+    jspp_set_shape(&parser, &shape);
+    while (token > JSON_CONTINUE) {
+        if (token == JSON_MEMBER_NAME && parser.level == 2) {
+            check(num_names < 12);
+            text = jspp_text(&parser, &length);
+            check(length == strlen(member_names[num_names]));
+            check(strncmp(text, member_names[num_names], length) == 0);
+            ids[num_names] = jspp_member_id(&parser);
+            text = jspp_intern_name(&table, ids[num_names], &length);
+            check(text && length == strlen(member_names[num_names]));
+            check(strncmp(text, member_names[num_names], length) == 0);
+            ++num_names;
+        }
+        token = jspp_next(&parser);
+    }
+    check(token == JSON_END);
+    check(num_names == 12);
+    check(ids[0] == ids[3] && ids[0] == ids[6] && ids[0] == ids[9]);
+    check(ids[2] == ids[5] && ids[2] == ids[8] && ids[2] == ids[11]);
+    check(ids[7] == ids[10]);
+    // the first object is not predicted, "type" is not predicted in the third one
+    check(shape.hits == 8);
+    check(shape.misses == 4);
+
+    return 0;
+}
+
+static int write_json()
+{
+    jspp_writer_t writer;
+    output_t output;
+    char buffer[64];
+
+    const char json[] =
+        "{\"id\":-9223372036854775808,\"name\":\"a \\\"quoted\\\" \\\\ name\\n\\u0001\","
+        "\"values\":[0,-0,0.1,1.5e300,-2.5e-7,0.000001,123456789012345680,null,true,false,[],{}]}\n42";
+
+    // output is flushed in different sizes
+    for (uint16_t buffer_size = 1; buffer_size <= sizeof(buffer); buffer_size++) {
+        output.length = 0;
+        jspp_writer_init(&writer, buffer, buffer_size, collect_output, &output);
+        check(JSON_OBJECT_BEGIN == jspp_write_object_begin(&writer));
+        check(JSON_MEMBER_NAME == jspp_write_member_name(&writer, "id", 2));
+        check(JSON_INTEGER == jspp_write_integer(&writer, INT64_MIN));
+        check(JSON_MEMBER_NAME == jspp_write_member_name(&writer, "name", 4));
+        check(JSON_STRING == jspp_write_string(&writer, "a \"quoted\" \\ name\n\1", 19));
+        check(JSON_MEMBER_NAME == jspp_write_member_name(&writer, "values", 6));
+        check(JSON_ARRAY_BEGIN == jspp_write_array_begin(&writer));
+        check(JSON_FLOATING_POINT == jspp_write_double(&writer, 0.0));
+        check(JSON_FLOATING_POINT == jspp_write_double(&writer, -0.0));
+        check(JSON_FLOATING_POINT == jspp_write_double(&writer, 0.1));
+        check(JSON_FLOATING_POINT == jspp_write_double(&writer, 1.5e300));
+        check(JSON_FLOATING_POINT == jspp_write_double(&writer, -2.5e-7));
+        check(JSON_FLOATING_POINT == jspp_write_double(&writer, 1e-6));
+        check(JSON_FLOATING_POINT == jspp_write_double(&writer, 123456789012345678.0));
+        check(JSON_NULL == jspp_write_double(&writer, 1e308 * 10));
+        check(JSON_TRUE == jspp_write_bool(&writer, 1));
+        check(JSON_FALSE == jspp_write_bool(&writer, 0));
+        check(JSON_ARRAY_BEGIN == jspp_write_array_begin(&writer));
+        check(JSON_ARRAY_END == jspp_write_array_end(&writer));
+        check(JSON_OBJECT_BEGIN == jspp_write_object_begin(&writer));
+        check(JSON_OBJECT_END == jspp_write_object_end(&writer));
+        check(JSON_CONTINUE == jspp_write_flush(&writer));
+        check(JSON_ARRAY_END == jspp_write_array_end(&writer));
+        check(JSON_OBJECT_END == jspp_write_object_end(&writer));
+        check(JSON_INTEGER == jspp_write_integer(&writer, 42));
+        check(JSON_END == jspp_write_flush(&writer));
+        check(output.length == sizeof(json) - 1);
+        check(memcmp(output.text, json, output.length) == 0);
+    }
+
+    // misuse
+    jspp_writer_init(&writer, buffer, sizeof(buffer), NULL, NULL);
+    check(JSON_INVALID == jspp_write_member_name(&writer, "id", 2));
+    check(JSON_INVALID == jspp_write_array_end(&writer));
+    check(JSON_OBJECT_BEGIN == jspp_write_object_begin(&writer));
+    check(JSON_INVALID == jspp_write_null(&writer));
+    check(JSON_INVALID == jspp_write_array_end(&writer));
+    check(JSON_MEMBER_NAME == jspp_write_member_name(&writer, "id", 2));
+    check(JSON_INVALID == jspp_write_member_name(&writer, "id", 2));
+    check(JSON_INVALID == jspp_write_object_end(&writer));
+
+    // there is no flush callback to empty the full buffer
+    jspp_writer_init(&writer, buffer, 8, NULL, NULL);
+    check(JSON_STRING == jspp_write_string(&writer, "123456", 6));
+    check(JSON_TOO_DEEP == jspp_write_string(&writer, "123456", 6));
+
+    return 0;
+}
+
+///< Feeds the JSON to the filter in fragments and compares the output to the expected text
+static int run_filter(const char * const * paths, uint8_t mode, const char * json, const char * expected)
+{
+    jspp_filter_t filter;
+    output_t output;
+    char buffer[16];
+    uint16_t json_length = strlen(json);
+
+    for (uint16_t fragment_size = 1; fragment_size <= json_length; fragment_size++) {
+        output.length = 0;
+        jspp_filter_init(&filter, paths, mode, buffer, sizeof(buffer), collect_output, &output);
+        uint8_t token = JSON_CONTINUE;
+        for (uint16_t pos = 0; pos < json_length && token == JSON_CONTINUE; pos += fragment_size) {
+            uint16_t size = json_length - pos;
+            token = jspp_filter_feed(&filter, json + pos, size < fragment_size ? size : fragment_size);
+        }
+        check(JSON_END == token);
+        check(output.length == strlen(expected));
+        check(memcmp(output.text, expected, output.length) == 0);
+    }
+    return 0;
+}
+
+static int filter_json()
+{
+    const char json[] =
+        "{ \"status\" : \"OK\", \"results\": [\n"
+        "    { \"name\": \"one\", \"geometry\": { \"location\": { \"lat\": 1.5, \"lng\": -2e3 }, \"bounds\": [ 1, 2 ] }, \"tags\": [] },\n"
+        "    { \"name\": \"two\", \"geometry\": null, \"names\": [ \"t\\\"w\\\"o\", true, false ] }\n"
+        "] }";
+    const char * const no_paths[] = { NULL };
+    const char * const drop_paths[] = { "results/*/geometry", "status", "results/*/names/*", NULL };
+    const char * const keep_paths[] = { "results/*/name", "results/*/geometry/location/lng", "missing", NULL };
+    const char * const prefix_paths[] = { "results/geometry/location", "*/a", NULL };
+    const char * const long_name_paths[] = { "*/*/b", NULL };
+    int rc;
+
+    if ((rc = run_filter(no_paths, JSPP_FILTER_DROP, json,
+        "{\"status\":\"OK\",\"results\":["
+        "{\"name\":\"one\",\"geometry\":{\"location\":{\"lat\":1.5,\"lng\":-2e3},\"bounds\":[1,2]},\"tags\":[]},"
+        "{\"name\":\"two\",\"geometry\":null,\"names\":[\"t\\\"w\\\"o\",true,false]}]}"))) {
+        return rc;
+    }
+    if ((rc = run_filter(drop_paths, JSPP_FILTER_DROP, json,
+        "{\"results\":[{\"name\":\"one\",\"tags\":[]},{\"name\":\"two\",\"names\":[]}]}"))) {
+        return rc;
+    }
+    if ((rc = run_filter(keep_paths, JSPP_FILTER_KEEP, json,
+        "{\"results\":[{\"name\":\"one\",\"geometry\":{\"location\":{\"lng\":-2e3}}},{\"name\":\"two\"}]}"))) {
+        return rc;
+    }
+    // scalars that match only a prefix of a path are dropped
+    if ((rc = run_filter(prefix_paths, JSPP_FILTER_KEEP,
+        "{\"results\":\"big string\",\"other\":1,\"status\":{\"a\":[1]},\"n\":null,\"results\":{\"geometry\":{\"location\":2}}}",
+        "{\"status\":{\"a\":[1]},\"results\":{\"geometry\":{\"location\":2}}}"))) {
+        return rc;
+    }
+    if ((rc = run_filter(long_name_paths, JSPP_FILTER_KEEP,
+        "[{\"a_member_name_that_is_longer_than_the_buffer_the_filter_holds_names_in\":{\"b\":1,\"c\":2}},3]",
+        "[{\"a_member_name_that_is_longer_than_the_buffer_the_filter_holds_names_in\":{\"b\":1}}]"))) {
+        return rc;
+    }
+    // the long name has been written before its value is known, so a scalar value is kept too
+    if ((rc = run_filter(long_name_paths, JSPP_FILTER_KEEP,
+        "[{\"a_member_name_that_is_longer_than_the_buffer_the_filter_holds_names_in\":5,\"c\":{\"b\":1}}]",
+        "[{\"a_member_name_that_is_longer_than_the_buffer_the_filter_holds_names_in\":5,\"c\":{\"b\":1}}]"))) {
+        return rc;
+    }
+    if ((rc = run_filter(no_paths, JSPP_FILTER_KEEP, json, "{}"))) {
+        return rc;
+    }
+
+    // paths beyond the limit are not dropped silently
+    const char * too_many_paths[JSPP_FILTER_MAX_PATHS + 2];
+    for (uint8_t i = 0; i <= JSPP_FILTER_MAX_PATHS; i++) {
+        too_many_paths[i] = "status";
+    }
+    too_many_paths[JSPP_FILTER_MAX_PATHS + 1] = NULL;
+    jspp_filter_t filter;
+    char buffer[16];
+    output_t output;
+    output.length = 0;
+    check(-1 == jspp_filter_init(&filter, too_many_paths, JSPP_FILTER_DROP, buffer, sizeof(buffer), collect_output, &output));
+    check(JSON_INVALID == jspp_filter_feed(&filter, json, sizeof(json) - 1));
+    too_many_paths[JSPP_FILTER_MAX_PATHS] = NULL;
+    check(0 == jspp_filter_init(&filter, too_many_paths, JSPP_FILTER_DROP, buffer, sizeof(buffer), collect_output, &output));
+    check(JSON_END == jspp_filter_feed(&filter, json, sizeof(json) - 1));
+    return 0;
+}
+
+///< Feeds the JSON to the transcoder in fragments and compares the output to the expected encoding
+static int run_transcoder(uint8_t format, uint16_t buffer_size, const char * json, const uint8_t * expected, uint16_t expected_size)
+{
+    jspp_transcoder_t transcoder;
+    output_t output;
+    uint8_t buffer[128];
+    uint16_t json_length = strlen(json);
+
+    for (uint16_t fragment_size = 1; fragment_size <= json_length; fragment_size++) {
+        output.length = 0;
+        jspp_transcoder_init(&transcoder, format, buffer, buffer_size, collect_output, &output);
+        uint8_t token = JSON_CONTINUE;
+        for (uint16_t pos = 0; pos < json_length && token == JSON_CONTINUE; pos += fragment_size) {
+            uint16_t size = json_length - pos;
+            token = jspp_transcode_feed(&transcoder, json + pos, size < fragment_size ? size : fragment_size);
+        }
+        check(JSON_END == token);
+        check(output.length == expected_size);
+        check(memcmp(output.text, expected, output.length) == 0);
+    }
+    return 0;
+}
+
+static int transcode_json()
+{
+    const char json[] =
+        "{ \"a\" : [ 1, -1, 300, -200, 1.5, \"x\\u00e9\\ud83d\\ude00\\n\\/\\ud800\", true, null, 9223372036854775808 ],"
+        " \"b\": {} }";
+    static const uint8_t msgpack[] = {
+        0x82, 0xa1, 0x61, 0x99, 0x01, 0xff, 0xcd, 0x01, 0x2c, 0xd1, 0xff, 0x38, 0xcb, 0x3f, 0xf8, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0xac, 0x78, 0xc3, 0xa9, 0xf0, 0x9f, 0x98, 0x80, 0x0a, 0x2f, 0xef,
+        0xbf, 0xbd, 0xc3, 0xc0, 0xcb, 0x43, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa1, 0x62, 0x80
+    };
+    static const uint8_t cbor[] = {
+        0xbf, 0x61, 0x61, 0x9f, 0x01, 0x20, 0x19, 0x01, 0x2c, 0x38, 0xc7, 0xfb, 0x3f, 0xf8, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x6c, 0x78, 0xc3, 0xa9, 0xf0, 0x9f, 0x98, 0x80, 0x0a, 0x2f, 0xef, 0xbf,
+        0xbd, 0xf5, 0xf6, 0xfb, 0x43, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x61, 0x62, 0xbf,
+        0xff, 0xff
+    };
+    int rc;
+
+    // the map and the array headers stay reserved until they end
+    if ((rc = run_transcoder(JSPP_MSGPACK, sizeof(msgpack) + 8, json, msgpack, sizeof(msgpack)))) {
+        return rc;
+    }
+    // CBOR output does not have to stay in the buffer
+    if ((rc = run_transcoder(JSPP_CBOR, 20, json, cbor, sizeof(cbor)))) {
+        return rc;
+    }
+
+    // headers that need a length byte or two
+    char long_json[80] = "[\"";
+    uint8_t long_msgpack[72] = { 0x92, 0xd9, 40 };
+    uint8_t long_cbor[72] = { 0x9f, 0x78, 40 };
+    for (int i = 0; i < 40; i++) {
+        strcat(long_json, "s");
+        long_msgpack[3 + i] = 's';
+        long_cbor[3 + i] = 's';
+    }
+    strcat(long_json, "\", [");
+    long_msgpack[43] = 0xdc;
+    long_msgpack[44] = 0;
+    long_msgpack[45] = 16;
+    long_cbor[43] = 0x9f;
+    for (int i = 0; i < 16; i++) {
+        strcat(long_json, i ? ",0" : "0");
+        long_msgpack[46 + i] = 0;
+        long_cbor[44 + i] = 0;
+    }
+    strcat(long_json, "]]");
+    long_cbor[60] = 0xff;
+    long_cbor[61] = 0xff;
+    if ((rc = run_transcoder(JSPP_MSGPACK, 128, long_json, long_msgpack, 62))) {
+        return rc;
+    }
+    if ((rc = run_transcoder(JSPP_CBOR, 128, long_json, long_cbor, 62))) {
+        return rc;
+    }
+
+    // MessagePack map does not fit
+    jspp_transcoder_t transcoder;
+    uint8_t buffer[sizeof(msgpack) - 1];
+    jspp_transcoder_init(&transcoder, JSPP_MSGPACK, buffer, sizeof(buffer), NULL, NULL);
+    check(JSON_TOO_DEEP == jspp_transcode_feed(&transcoder, json, sizeof(json) - 1));
+
+    return 0;
+}
+
+static int pipeline_fragments()
+{
+    jspp_pipeline_t pipeline;
+    char buffers[3][8];
+    char * buffer;
+    const char * text;
+    uint16_t length;
+
+    const char json[] = "{ \"name\": \"a long string\", \"values\": [ 1, 22, 333 ] }";
+    static const uint8_t tokens[] = {
+        JSON_OBJECT_BEGIN, JSON_MEMBER_NAME, JSON_STRING_PART, JSON_STRING_PART, JSON_STRING, JSON_MEMBER_NAME_PART,
+        JSON_MEMBER_NAME, JSON_ARRAY_BEGIN, JSON_NUMBER_PART, JSON_INTEGER, JSON_INTEGER, JSON_NUMBER_PART,
+        JSON_INTEGER, JSON_ARRAY_END, JSON_OBJECT_END, JSON_END
+    };
+
+    jspp_pipeline_init(&pipeline, buffers[0], 3, sizeof(buffers[0]));
+    check(JSON_CONTINUE == jspp_pipeline_next(&pipeline));
+
+    size_t i = 0;
+    uint16_t pos = 0;
+    uint8_t token = JSON_CONTINUE;
+    while (token != JSON_END) {
+        if (token == JSON_CONTINUE) {
+            // the reader fills all the buffers the parser has returned
+            uint8_t num_filled = 0;
+            while (pos < sizeof(json) - 1 && (buffer = jspp_pipeline_acquire(&pipeline)) != NULL) {
+                uint16_t size = sizeof(json) - 1 - pos;
+                if (size > sizeof(buffers[0])) {
+                    size = sizeof(buffers[0]);
+                }
+                memcpy(buffer, json + pos, size);
+                jspp_pipeline_publish(&pipeline, buffer, size);
+                pos += size;
+                ++num_filled;
+            }
+            check(num_filled > 0);
+        } else {
+            check(i < sizeof(tokens));
+            check(tokens[i++] == token);
+            if (token == JSON_INTEGER && i == 11) {
+                text = jspp_text(&pipeline.parser, &length);
+                check(length == 2 && strncmp(text, "22", 2) == 0);
+                check(text >= pipeline.current && text < pipeline.current + sizeof(buffers[0]));
+            }
+        }
+        token = jspp_pipeline_next(&pipeline);
+    }
+    check(i == sizeof(tokens) - 1);
+    check(pos == sizeof(json) - 1);
+
+    // skipping through the pipeline
+    jspp_pipeline_init(&pipeline, buffers[0], 3, sizeof(buffers[0]));
+    for (pos = 0; pos < 3 * sizeof(buffers[0]); pos += sizeof(buffers[0])) {
+        buffer = jspp_pipeline_acquire(&pipeline);
+        memcpy(buffer, json + pos, sizeof(buffers[0]));
+        jspp_pipeline_publish(&pipeline, buffer, sizeof(buffers[0]));
+    }
+    check(JSON_OBJECT_BEGIN == jspp_pipeline_next(&pipeline));
+    check(JSON_MEMBER_NAME == jspp_pipeline_next(&pipeline));
+    // the value continues past the published fragments
+    check(JSON_CONTINUE == jspp_pipeline_resume(&pipeline, jspp_skip(&pipeline.parser)));
+    buffer = jspp_pipeline_acquire(&pipeline);
+    check(buffer != NULL);
+    memcpy(buffer, json + pos, sizeof(buffers[0]));
+    jspp_pipeline_publish(&pipeline, buffer, sizeof(buffers[0]));
+    check(JSON_MEMBER_NAME_PART == jspp_pipeline_next(&pipeline));
+    text = jspp_text(&pipeline.parser, &length);
+    check(length == 4 && strncmp(text, "valu", 4) == 0);
+
+    // the stream ends before JSON does
+    buffer = jspp_pipeline_acquire(&pipeline);
+    check(buffer != NULL);
+    jspp_pipeline_publish(&pipeline, buffer, 0);
+    check(JSON_INVALID == jspp_pipeline_next(&pipeline));
+    check(JSON_INVALID == jspp_pipeline_next(&pipeline));
+
+    return 0;
+}
+
+static int batch_streams()
+{
+    const char * fragments[3][2] = {
+        { "{\"a\":[1,", "2]}" },
+        { "[\"x\",", "true]" },
+        { "nu", "ll" }
+    };
+    jspp_t parsers[3];
+    jspp_batch_token_t tokens[3][3];
+    jspp_batch_job_t jobs[3];
+    const char * text;
+
+    for (int i = 0; i < 3; i++) {
+        check(JSON_CONTINUE == jspp_start(&parsers[i], "", 0));
+        jobs[i].parser = &parsers[i];
+        jobs[i].tokens = tokens[i];
+        jobs[i].capacity = 3;
+        jobs[i].status = JSON_CONTINUE;
+        jobs[i].text = fragments[i][0];
+        jobs[i].text_len = strlen(fragments[i][0]);
+    }
+    jspp_batch_run(jobs, 3);
+
+    // the token array is full
+    check(jobs[0].count == 3);
+    check(jobs[0].status == JSON_INTEGER);
+    check(tokens[0][0].token == JSON_OBJECT_BEGIN);
+    check(tokens[0][1].token == JSON_MEMBER_NAME);
+    text = jobs[0].text + tokens[0][1].start;
+    check(tokens[0][1].length == 1 && text[0] == 'a');
+    check(tokens[0][2].token == JSON_ARRAY_BEGIN);
+
+    check(jobs[1].count == 2);
+    check(jobs[1].status == JSON_CONTINUE);
+    check(tokens[1][0].token == JSON_ARRAY_BEGIN);
+    check(tokens[1][1].token == JSON_STRING);
+    text = jobs[1].text + tokens[1][1].start;
+    check(tokens[1][1].length == 1 && text[0] == 'x');
+
+    check(jobs[2].count == 0);
+    check(jobs[2].status == JSON_CONTINUE);
+
+    // the first job continues with the token that did not fit
+    for (int i = 1; i < 3; i++) {
+        jobs[i].text = fragments[i][1];
+        jobs[i].text_len = strlen(fragments[i][1]);
+    }
+    jspp_batch_run(jobs, 3);
+    check(jobs[0].count == 1);
+    check(jobs[0].status == JSON_CONTINUE);
+    check(tokens[0][0].token == JSON_INTEGER);
+    text = jobs[0].text + tokens[0][0].start;
+    check(tokens[0][0].length == 1 && text[0] == '1');
+
+    check(jobs[1].count == 2);
+    check(jobs[1].status == JSON_END);
+    check(tokens[1][0].token == JSON_TRUE);
+    check(tokens[1][1].token == JSON_ARRAY_END);
+
+    check(jobs[2].count == 1);
+    check(jobs[2].status == JSON_END);
+    check(tokens[2][0].token == JSON_NULL);
+
+    jobs[0].text = fragments[0][1];
+    jobs[0].text_len = strlen(fragments[0][1]);
+    jspp_batch_run(jobs, 1);
+    check(jobs[0].count == 3);
+    check(jobs[0].status == JSON_END);
+    check(tokens[0][0].token == JSON_INTEGER);
+    check(tokens[0][1].token == JSON_ARRAY_END);
+    check(tokens[0][2].token == JSON_OBJECT_END);
+
+    return 0;
+}
+
+typedef struct _index_entry {
+    uint8_t  path;
+    uint64_t element;
+    uint8_t  checkpoint[JSPP_CHECKPOINT_SIZE];
+    uint16_t size;
+} index_entry_t;
+
+typedef struct _index_entries {
+    index_entry_t   entries[16];
+    uint8_t         count;
+} index_entries_t;
+
+static void collect_index_entry(uint8_t path, uint64_t element, const uint8_t * checkpoint, uint16_t size, void * cb_data)
+{
+    index_entries_t * index = cb_data;
+    if (index->count < 16) {
+        index_entry_t * entry = &index->entries[index->count++];
+        entry->path = path;
+        entry->element = element;
+        entry->size = size;
+        memcpy(entry->checkpoint, checkpoint, size);
+    }
+}
+
+static int index_document()
+{
+    static const char * const paths[] = { "items", "meta/name", NULL };
+    static const char * const elements[] = { "0", "s1", "{", "[", "4", "5.5", "6", "null", "8", "true" };
+    const char json[] = "{ \"meta\": { \"items\": [ 1 ], \"name\": \"x\" }, \"other\": { \"items\": [] },"
+        " \"items\": [ 0, \"s1\", { \"a\": [ 2 ] }, [ 3 ], 4, 5.5, 6, null, 8, true ] }";
+    jspp_index_t index;
+    index_entries_t result;
+    jspp_t parser;
+    jspp_search_t search;
+    const char * text;
+    uint16_t length;
+    uint64_t offset;
+
+    for (uint16_t fragment_size = 1; fragment_size <= sizeof(json) - 1; fragment_size++) {
+        result.count = 0;
+        jspp_index_init(&index, paths, 3, collect_index_entry, &result);
+        uint8_t token = JSON_CONTINUE;
+        for (uint16_t pos = 0; pos < sizeof(json) - 1 && token == JSON_CONTINUE; pos += fragment_size) {
+            uint16_t size = sizeof(json) - 1 - pos;
+            token = jspp_index_feed(&index, json + pos, size < fragment_size ? size : fragment_size);
+        }
+        check(token == JSON_END);
+
+        // the name, the array and every third element of the array
+        check(result.count == 6);
+        check(result.entries[0].path == 1 && result.entries[0].element == JSPP_INDEX_VALUE);
+        check(result.entries[1].path == 0 && result.entries[1].element == JSPP_INDEX_VALUE);
+        for (uint32_t i = 0; i < 4; i++) {
+            check(result.entries[2 + i].path == 0 && result.entries[2 + i].element == i * 3);
+        }
+
+        check(JSON_CONTINUE == jspp_restore(&parser, result.entries[0].checkpoint, result.entries[0].size, &offset));
+        check(JSON_STRING == jspp_continue(&parser, json + offset, sizeof(json) - 1 - offset));
+        check_text("x");
+
+        // resume from the nearest checkpoint and skip the rest
+        for (int i = 0; i < 10; i++) {
+            index_entry_t * entry = &result.entries[2 + i / 3];
+            check(JSON_CONTINUE == jspp_restore(&parser, entry->checkpoint, entry->size, &offset));
+            token = jspp_seek_index(&parser, &search, i % 3);
+            if (token == JSON_CONTINUE) {
+                token = jspp_continue(&parser, json + offset, sizeof(json) - 1 - offset);
+            }
+            check(token > JSON_CONTINUE && token != JSON_ARRAY_END);
+            text = jspp_text(&parser, &length);
+            if (token == JSON_OBJECT_BEGIN || token == JSON_ARRAY_BEGIN) {
+                check(json[parser.text_offset + parser.token_start] == elements[i][0]);
+            } else {
+                check(length == strlen(elements[i]) && strncmp(text, elements[i], length) == 0);
+            }
+        }
+    }
+    return 0;
+}
+
+typedef struct _selected {
+    const char *    records[4];
+    uint32_t        lengths[4];
+    int             count;
+} selected_t;
+
+static void select_record(const char * record, uint32_t length, void * cb_data)
+{
+    selected_t * selected = cb_data;
+    if (selected->count < 4) {
+        selected->records[selected->count] = record;
+        selected->lengths[selected->count] = length;
+    }
+    ++selected->count;
+}
+
+static int select_records()
+{
+    static const char ndjson[] =
+        "{\"level\":\"error\",\"code\":500,\"msg\":\"disk\"}\n"
+        "{\"level\":\"info\",\"code\":500,\"msg\":\"error\"}\n"
+        "{\"msg\":\"x\",\"level\" : \"error\",\"code\":404}\n"
+        "\n"
+        "{\"nested\":{\"level\":\"error\"},\"code\":500}\n"
+        "{\"code\":500,\"ok\":true,\"level\":\"error\"}\r\n"
+        "[{\"level\":\"error\",\"code\":500}]\n"
+        "{\"level\":\"error\",\"code\":5";
+    static const jspp_predicate_t predicates[] = {
+        { "code", "500" },
+        { "level", "\"error\"" },
+    };
+    static const jspp_predicate_t literal[] = {
+        { "ok", "true" },
+    };
+    jspp_select_t select;
+    selected_t selected = { 0 };
+    uint32_t length = sizeof(ndjson) - 1;
+    uint32_t tail = strrchr(ndjson, '\n') + 1 - ndjson;
+
+    jspp_select_init(&select, predicates, 2, select_record, &selected);
+    check(select.scan == 1);
+    check(tail == jspp_select_records(&select, ndjson, length, 0));
+    check(selected.count == 2);
+    check(selected.records[0] == ndjson && selected.lengths[0] == strchr(ndjson, '\n') - ndjson);
+    check(strncmp(selected.records[1], "{\"code\":500,\"ok\"", 16) == 0);
+    check(selected.records[1][selected.lengths[1]] == '\n');
+    // the prefilter has rejected the record with 404 and the parser has rejected the rest
+    check(select.candidates == 5);
+    // the incomplete record is passed again with the end of the stream
+    check(length - tail == jspp_select_records(&select, ndjson + tail, length - tail, 1));
+    check(selected.count == 2);
+    check(select.selected == 2);
+
+    selected.count = 0;
+    jspp_select_init(&select, literal, 1, select_record, &selected);
+    check(length == jspp_select_records(&select, ndjson, length, 1));
+    check(selected.count == 1 && strncmp(selected.records[0], "{\"code\":500,\"ok\"", 16) == 0);
+
+    // without predicates every record that is an object is selected
+    selected.count = 0;
+    jspp_select_init(&select, NULL, 0, select_record, &selected);
+    check(tail == jspp_select_records(&select, ndjson, length, 0));
+    check(selected.count == 5);
+    return 0;
+}
+
+static int decode_base64()
+{
+    static const char json[] =
+        "[\"+\\/+\\/\\/AA\\/TWFueSBoYW5kcyBtYWtl\\nIGxpZ2h0IHdvcmsu\", \"-_-__AA_TWFueSBoYW5kcyBtYWtlIGxpZ2h0IHdvcmsu\","
+        " \"bGlnaHQgdw==\", \"bGlnaHQgdw\", \"bGlnaHQgd=w\", \"bG!n\", \"bGlnaHQgdw\\\"\"]";
+    static const char blob[] = "\xfb\xff\xbf\xfc\x00\x3fMany hands make light work.";
+    static const char * const expected[] = { blob, blob, "light w", "light w", NULL, NULL, NULL };
+
+    for (uint16_t size = 1; size < sizeof(json); size++) {
+        jspp_t parser;
+        jspp_base64_t decoder;
+        output_t output = { .length = 0 };
+        jspp_base64_init(&decoder, collect_output, &output);
+
+        uint16_t pos = size;
+        int index = 0;
+        uint8_t valid = 1;
+        uint8_t token = jspp_start(&parser, json, size);
+        while (token != JSON_END) {
+            if (token == JSON_CONTINUE) {
+                check(pos < sizeof(json) - 1);
+                uint16_t len = sizeof(json) - 1 - pos < size ? sizeof(json) - 1 - pos : size;
+                token = jspp_continue(&parser, json + pos, len);
+                pos += len;
+                continue;
+            }
+            check(token != JSON_INVALID);
+            if (token == JSON_STRING_PART || token == JSON_STRING) {
+                valid &= jspp_base64_decode(&decoder, &parser);
+            }
+            if (token == JSON_STRING) {
+                if (expected[index]) {
+                    uint16_t length = expected[index] == blob ? sizeof(blob) - 1 : strlen(expected[index]);
+                    check(valid && output.length == length && memcmp(output.text, expected[index], length) == 0);
+                } else {
+                    check(!valid);
+                }
+                output.length = 0;
+                valid = 1;
+                ++index;
+            }
+            token = jspp_next(&parser);
+        }
+        check(index == 7);
+        check(decoder.decoded == 2 * (sizeof(blob) - 1) + 2 * 7);
+    }
+    return 0;
+}
+
 int main()
 {
     test(parse_simple_json, "Parse a one element JSON");
@@ -542,9 +1994,28 @@ int main()
     test(parse_split_array, "Parse array that continues in another transmission fragment");
     test(parse_object, "Parse JSON objects");
     test(parse_split_object, "Parse object split between transmission fragments");
+    test(parse_long_runs, "Parse long runs of whitespace, string characters and digits");
     test(skip_elements, "Skip JSON elements");
     test(skip_split_values, "Skip split numbers and strings");
     test(skip_current, "Skip current element");
+    test(convert_doubles, "Convert numbers to correctly rounded doubles");
+    test(bind_struct, "Bind JSON object to a struct");
+    test(record_tape, "Record JSON tokens on a tape and navigate it");
+    test(find_member, "Find object member by name");
+    test(seek_array_elements, "Seek and count array elements");
+    test(read_number_arrays, "Read arrays of numbers");
+    test(checkpoint_restore, "Save and restore parser state");
+    test(capture_elements, "Capture raw text of JSON elements");
+    test(intern_member_names, "Intern member names");
+    test(predict_shape, "Predict member names of records");
+    test(write_json, "Write JSON");
+    test(filter_json, "Filter JSON");
+    test(transcode_json, "Transcode JSON to MessagePack and CBOR");
+    test(pipeline_fragments, "Pass fragments from the reader to the parser through the pipeline");
+    test(batch_streams, "Parse fragments of several streams in a batch");
+    test(index_document, "Index JSON document and resume parsing from the index");
+    test(select_records, "Select NDJSON records by member values");
+    test(decode_base64, "Decode base64 strings");
     printf("DONE: %d/%d\n", num_tests_passed, num_tests_passed + num_tests_failed);
     return num_tests_failed > 0;
 }